@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace uni_course_cpp {
+// Blocking FIFO with a fixed capacity, used to connect pipeline stages.
+// `push` waits while the queue is full, `pop` waits while it is empty.
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(int capacity)
+      : capacity_(capacity > 0 ? capacity : 1) {}
+
+  // Returns false if the queue was closed and `value` was dropped
+  bool push(T value) {
+    std::unique_lock lock(mutex_);
+    not_full_.wait(
+        lock, [this]() { return is_closed_ || items_.size() < capacity_; });
+    if (is_closed_) {
+      return false;
+    }
+    items_.push_back(std::move(value));
+    lock.unlock();
+    not_empty_.notify_one();
+    return true;
+  }
+
+  // Returns `std::nullopt` once the queue is closed and drained
+  std::optional<T> pop() {
+    std::unique_lock lock(mutex_);
+    not_empty_.wait(lock, [this]() { return is_closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return std::nullopt;
+    }
+    auto value = std::move(items_.front());
+    items_.pop_front();
+    lock.unlock();
+    not_full_.notify_one();
+    return value;
+  }
+
+  // Wakes everyone up; queued items can still be popped
+  void close() {
+    {
+      const std::lock_guard lock(mutex_);
+      is_closed_ = true;
+    }
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+ private:
+  const int capacity_;
+  std::deque<T> items_;
+  bool is_closed_ = false;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+};
+}  // namespace uni_course_cpp
@@ -0,0 +1,159 @@
+#include "dynamic_shortest_paths.hpp"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
+namespace {
+constexpr int MAX_COST = INT_MAX;
+constexpr uni_course_cpp::EdgeId NO_EDGE_ID = -1;
+
+int get_edge_hops(const uni_course_cpp::Edge&) {
+  return 1;
+}
+
+int get_edge_duration(const uni_course_cpp::Edge& edge) {
+  return edge.get_duration();
+}
+}  // namespace
+
+namespace uni_course_cpp {
+
+DynamicShortestPaths::DynamicShortestPaths(Graph& graph,
+                                           VertexId source_vertex_id)
+    : graph_(graph),
+      source_vertex_id_(source_vertex_id),
+      known_edges_count_(graph.get_edges().size()) {
+  resize_trees();
+  distance_tree_.costs[source_vertex_id_] = 0;
+  duration_tree_.costs[source_vertex_id_] = 0;
+  last_updated_count_ =
+      propagate(distance_tree_, {{0, source_vertex_id_}}, get_edge_hops) +
+      propagate(duration_tree_, {{0, source_vertex_id_}}, get_edge_duration);
+}
+
+void DynamicShortestPaths::add_edge(VertexId first_vertex_id,
+                                    VertexId second_vertex_id,
+                                    RandomGenerator& random_generator) {
+  check_graph();
+  graph_.add_edge(first_vertex_id, second_vertex_id, random_generator);
+  ++known_edges_count_;
+  resize_trees();
+  const auto& edge = graph_.get_edges().back();
+  last_updated_count_ = relax_edge(distance_tree_, edge, get_edge_hops) +
+                        relax_edge(duration_tree_, edge, get_edge_duration);
+}
+
+template <typename EdgeCost>
+int DynamicShortestPaths::propagate(Tree& tree,
+                                    std::vector<QueuedVertex>&& queue,
+                                    const EdgeCost& edge_cost) const {
+  std::priority_queue<QueuedVertex, std::vector<QueuedVertex>, std::greater<>>
+      vertex_queue(std::greater<>(), std::move(queue));
+  int settled_count = 0;
+  while (!vertex_queue.empty()) {
+    const auto [cost, vertex_id] = vertex_queue.top();
+    vertex_queue.pop();
+    if (cost != tree.costs[vertex_id]) {
+      continue;
+    }
+    ++settled_count;
+    for (const auto edge_id : graph_.get_connected_edges_ids(vertex_id)) {
+      const auto& edge = graph_.get_edge(edge_id);
+      const auto next_vertex_id =
+          edge.get_first_vertex_id() + edge.get_second_vertex_id() - vertex_id;
+      const auto next_cost = cost + edge_cost(edge);
+      if (next_cost < tree.costs[next_vertex_id]) {
+        tree.costs[next_vertex_id] = next_cost;
+        tree.parent_edge_ids[next_vertex_id] = edge_id;
+        vertex_queue.emplace(next_cost, next_vertex_id);
+      }
+    }
+  }
+  return settled_count;
+}
+
+template <typename EdgeCost>
+int DynamicShortestPaths::relax_edge(Tree& tree,
+                                     const Edge& edge,
+                                     const EdgeCost& edge_cost) {
+  std::vector<QueuedVertex> queue;
+  const auto relax = [&tree, &edge, &edge_cost, &queue](
+                         VertexId from_vertex_id, VertexId to_vertex_id) {
+    if (tree.costs[from_vertex_id] == MAX_COST) {
+      return;
+    }
+    const auto cost = tree.costs[from_vertex_id] + edge_cost(edge);
+    if (cost < tree.costs[to_vertex_id]) {
+      tree.costs[to_vertex_id] = cost;
+      tree.parent_edge_ids[to_vertex_id] = edge.get_id();
+      queue.emplace_back(cost, to_vertex_id);
+    }
+  };
+  relax(edge.get_first_vertex_id(), edge.get_second_vertex_id());
+  relax(edge.get_second_vertex_id(), edge.get_first_vertex_id());
+  return propagate(tree, std::move(queue), edge_cost);
+}
+
+void DynamicShortestPaths::resize_trees() {
+  for (auto* tree : {&distance_tree_, &duration_tree_}) {
+    tree->costs.resize(graph_.vertices_count(), MAX_COST);
+    tree->parent_edge_ids.resize(graph_.vertices_count(), NO_EDGE_ID);
+  }
+}
+
+void DynamicShortestPaths::check_graph() const {
+  if (graph_.get_edges().size() != known_edges_count_) {
+    throw std::runtime_error(
+        "Graph edges were added outside of DynamicShortestPaths!\n");
+  }
+}
+
+int DynamicShortestPaths::get_cost(const Tree& tree,
+                                   VertexId vertex_id) const {
+  check_graph();
+  // Vertices added since the last `add_edge` have no entry yet
+  return vertex_id < tree.costs.size() ? tree.costs[vertex_id] : MAX_COST;
+}
+
+GraphPath::Distance DynamicShortestPaths::get_distance(
+    VertexId vertex_id) const {
+  return get_cost(distance_tree_, vertex_id);
+}
+
+Edge::Duration DynamicShortestPaths::get_duration(VertexId vertex_id) const {
+  return get_cost(duration_tree_, vertex_id);
+}
+
+GraphPath DynamicShortestPaths::get_shortest_path(VertexId vertex_id) const {
+  return build_path(distance_tree_, vertex_id);
+}
+
+GraphPath DynamicShortestPaths::get_fastest_path(VertexId vertex_id) const {
+  return build_path(duration_tree_, vertex_id);
+}
+
+GraphPath DynamicShortestPaths::build_path(const Tree& tree,
+                                           VertexId vertex_id) const {
+  // `get_cost` checks the graph
+  if (get_cost(tree, vertex_id) == MAX_COST) {
+    return GraphPath(0, {}, {});
+  }
+  std::vector<VertexId> vertex_ids = {vertex_id};
+  std::vector<EdgeId> edge_ids;
+  Edge::Duration duration = 0;
+  while (vertex_id != source_vertex_id_) {
+    const auto& edge = graph_.get_edge(tree.parent_edge_ids[vertex_id]);
+    edge_ids.push_back(edge.get_id());
+    duration += edge.get_duration();
+    vertex_id =
+        edge.get_first_vertex_id() + edge.get_second_vertex_id() - vertex_id;
+    vertex_ids.push_back(vertex_id);
+  }
+  std::reverse(vertex_ids.begin(), vertex_ids.end());
+  std::reverse(edge_ids.begin(), edge_ids.end());
+  return GraphPath(duration, std::move(vertex_ids), std::move(edge_ids));
+}
+
+}  // namespace uni_course_cpp
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+#include "graph.hpp"
+#include "graph_path.hpp"
+#include "random_generator.hpp"
+
+namespace uni_course_cpp {
+// Shortest and fastest paths from one source of a `Graph` that keeps
+// growing. Edges added through `add_edge` only re-settle the vertices
+// whose distance or duration actually drops, in the style of
+// Ramalingam-Reps; insertions never make anything worse, so there is no
+// deletion phase. Vertices may be added to the graph directly and start
+// out unreachable, but edges must go through `add_edge`: every call throws
+// once the graph has gained edges behind the trees' back.
+class DynamicShortestPaths {
+ public:
+  DynamicShortestPaths(Graph& graph, VertexId source_vertex_id);
+
+  // Forwards to `Graph::add_edge` and updates both trees
+  void add_edge(VertexId first_vertex_id,
+                VertexId second_vertex_id,
+                RandomGenerator& random_generator);
+
+  VertexId source_vertex_id() const { return source_vertex_id_; }
+  // `INT_MAX` when unreachable
+  GraphPath::Distance get_distance(VertexId vertex_id) const;
+  Edge::Duration get_duration(VertexId vertex_id) const;
+  // Empty path when unreachable
+  GraphPath get_shortest_path(VertexId vertex_id) const;
+  GraphPath get_fastest_path(VertexId vertex_id) const;
+
+  // Vertices whose entries the last `add_edge` changed, in both trees
+  int last_updated_count() const { return last_updated_count_; }
+
+ private:
+  struct Tree {
+    std::vector<int> costs;
+    std::vector<EdgeId> parent_edge_ids;
+  };
+
+  using QueuedVertex = std::pair<int, VertexId>;
+
+  // Dijkstra over the vertices whose cost drops, starting from `queue`
+  // entries whose cost is already stored; returns how many it settled
+  template <typename EdgeCost>
+  int propagate(Tree& tree,
+                std::vector<QueuedVertex>&& queue,
+                const EdgeCost& edge_cost) const;
+  // Propagates from whichever end of a new edge it improves
+  template <typename EdgeCost>
+  int relax_edge(Tree& tree, const Edge& edge, const EdgeCost& edge_cost);
+  void resize_trees();
+  // Throws if the graph has edges the trees have not seen
+  void check_graph() const;
+  int get_cost(const Tree& tree, VertexId vertex_id) const;
+  GraphPath build_path(const Tree& tree, VertexId vertex_id) const;
+
+  Graph& graph_;
+  VertexId source_vertex_id_;
+  Tree distance_tree_;
+  Tree duration_tree_;
+  // Edges of `graph_` the trees account for
+  int known_edges_count_ = 0;
+  int last_updated_count_ = 0;
+};
+}  // namespace uni_course_cpp
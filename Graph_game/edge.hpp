@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "random_generator.hpp"
 #include "vertex.hpp"
 
 namespace uni_course_cpp {
@@ -13,7 +14,10 @@ struct Edge {
   Edge(EdgeId id,
        VertexId first_vertex_id,
        VertexId second_vertex_id,
-       const Edge::Color& color);
+       const Edge::Color& color,
+       Duration duration);
+  static Duration get_random_duration(const Edge::Color& color,
+                                      RandomGenerator& random_generator);
   EdgeId get_id() const;
   VertexId get_first_vertex_id() const;
   VertexId get_second_vertex_id() const;
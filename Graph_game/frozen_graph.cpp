@@ -0,0 +1,58 @@
+#include "frozen_graph.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace uni_course_cpp {
+
+FrozenGraph::FrozenGraph(const Graph& graph) : edges_(graph.get_edges()) {
+  const int vertices_count = graph.vertices_count();
+  for (int index = 0; index < edges_.size(); ++index) {
+    if (edges_[index].get_id() != index) {
+      throw std::runtime_error("Edge ids are not dense!\n");
+    }
+    const auto duration = edges_[index].get_duration();
+    min_duration_ = index == 0 ? duration : std::min(min_duration_, duration);
+    max_duration_ = std::max(max_duration_, duration);
+  }
+
+  offsets_.reserve(vertices_count + 1);
+  vertices_depth_.reserve(vertices_count);
+  offsets_.push_back(0);
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; ++vertex_id) {
+    if (graph.get_vertices()[vertex_id].get_id() != vertex_id) {
+      throw std::runtime_error("Vertex ids are not dense!\n");
+    }
+    offsets_.push_back(offsets_.back() +
+                       graph.get_connected_edges_ids(vertex_id).size());
+    vertices_depth_.push_back(graph.get_vertex_depth(vertex_id));
+  }
+
+  neighbor_ids_.reserve(offsets_.back());
+  edge_ids_.reserve(offsets_.back());
+  edge_colors_.reserve(offsets_.back());
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; ++vertex_id) {
+    for (const auto edge_id : graph.get_connected_edges_ids(vertex_id)) {
+      const auto& edge = edges_[edge_id];
+      edge_ids_.push_back(edge_id);
+      edge_colors_.push_back(make_color_mask({edge.get_color()}));
+      neighbor_ids_.push_back(edge.get_first_vertex_id() +
+                              edge.get_second_vertex_id() - vertex_id);
+      max_depth_gap_ = std::max(
+          max_depth_gap_,
+          std::abs(vertices_depth_[neighbor_ids_.back()] -
+                   vertices_depth_[vertex_id]));
+    }
+  }
+
+  depth_offsets_.reserve(graph.get_depth() + 1);
+  depth_offsets_.push_back(0);
+  for (Depth depth = 0; depth < graph.get_depth(); ++depth) {
+    const auto& vertex_ids = graph.get_vertex_ids_at_depth(depth);
+    depth_vertex_ids_.insert(depth_vertex_ids_.end(), vertex_ids.begin(),
+                             vertex_ids.end());
+    depth_offsets_.push_back(depth_vertex_ids_.size());
+  }
+}
+
+}  // namespace uni_course_cpp
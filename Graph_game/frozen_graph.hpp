@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+#include "array_view.hpp"
+#include "graph.hpp"
+
+namespace uni_course_cpp {
+// Immutable compressed sparse row snapshot of a finished `Graph`.
+// Vertex and edge ids are dense, so every lookup is a plain array access.
+class FrozenGraph {
+ public:
+  using Depth = Graph::Depth;
+  // One bit per `Edge::Color`
+  using ColorMask = uint8_t;
+  static constexpr ColorMask kAllColors = 0xF;
+
+  static ColorMask make_color_mask(std::initializer_list<Edge::Color> colors) {
+    ColorMask mask = 0;
+    for (const auto color : colors) {
+      mask |= ColorMask{1} << static_cast<int>(color);
+    }
+    return mask;
+  }
+
+  explicit FrozenGraph(const Graph& graph);
+
+  int vertices_count() const { return vertices_depth_.size(); }
+  int edges_count() const { return edges_.size(); }
+
+  const std::vector<Edge>& get_edges() const { return edges_; }
+  const Edge& get_edge(EdgeId id) const { return edges_[id]; }
+  // Shortest and longest edge durations, 0 for a graph without edges
+  Edge::Duration get_min_duration() const { return min_duration_; }
+  Edge::Duration get_max_duration() const { return max_duration_; }
+
+  Depth get_depth() const { return depth_offsets_.size() - 1; }
+  Depth get_vertex_depth(VertexId vertex_id) const {
+    return vertices_depth_[vertex_id];
+  }
+  // Largest depth difference between the ends of one edge
+  Depth get_max_depth_gap() const { return max_depth_gap_; }
+  ArrayView<VertexId> get_vertex_ids_at_depth(Depth depth) const {
+    return slice(depth_vertex_ids_, depth_offsets_, depth);
+  }
+
+  // Both views of a vertex are aligned: `get_neighbor_ids(v)[i]` is the
+  // opposite end of `get_connected_edges_ids(v)[i]`.
+  ArrayView<EdgeId> get_connected_edges_ids(VertexId vertex_id) const {
+    return slice(edge_ids_, offsets_, vertex_id);
+  }
+  ArrayView<VertexId> get_neighbor_ids(VertexId vertex_id) const {
+    return slice(neighbor_ids_, offsets_, vertex_id);
+  }
+  // Aligned the same way: the single color bit of each edge, so a color
+  // filter is a mask test on the adjacency list instead of an edge lookup
+  ArrayView<ColorMask> get_connected_edge_colors(VertexId vertex_id) const {
+    return slice(edge_colors_, offsets_, vertex_id);
+  }
+  int get_degree(VertexId vertex_id) const {
+    return offsets_[vertex_id + 1] - offsets_[vertex_id];
+  }
+  // Total length of all adjacency lists
+  int connections_count() const { return edge_ids_.size(); }
+
+ private:
+  template <typename T>
+  static ArrayView<T> slice(const std::vector<T>& values,
+                            const std::vector<int>& offsets,
+                            int index) {
+    return ArrayView<T>(values.data() + offsets[index],
+                        offsets[index + 1] - offsets[index]);
+  }
+
+  std::vector<int> offsets_;
+  std::vector<VertexId> neighbor_ids_;
+  std::vector<EdgeId> edge_ids_;
+  std::vector<ColorMask> edge_colors_;
+  std::vector<Edge> edges_;
+  Edge::Duration min_duration_ = 0;
+  Edge::Duration max_duration_ = 0;
+
+  std::vector<Depth> vertices_depth_;
+  Depth max_depth_gap_ = 0;
+  std::vector<int> depth_offsets_;
+  std::vector<VertexId> depth_vertex_ids_;
+};
+}  // namespace uni_course_cpp
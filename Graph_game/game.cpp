@@ -3,15 +3,33 @@
 
 namespace uni_course_cpp {
 GraphPath Game::find_shortest_path() const {
-  GraphTraverser graph_traverser(map_);
-  return graph_traverser.find_shortest_path(knight_position_,
-                                            princess_position_);
+  if (landmark_index_) {
+    return graph_traverser_->find_shortest_path(
+        knight_position_, princess_position_, *landmark_index_);
+  }
+  return graph_traverser_->find_guided_shortest_path(knight_position_,
+                                                    princess_position_);
 }
 
 GraphPath Game::find_fastest_path() const {
-  GraphTraverser graph_traverser(map_);
-  return graph_traverser.find_fastest_path(knight_position_,
-                                           princess_position_);
+  if (landmark_index_) {
+    return graph_traverser_->find_fastest_path(
+        knight_position_, princess_position_, *landmark_index_);
+  }
+  return graph_traverser_->find_guided_fastest_path(knight_position_,
+                                                   princess_position_);
+}
+
+GraphTraverser::BicriteriaPaths Game::find_shortest_and_fastest_paths()
+    const {
+  return graph_traverser_->find_bicriteria_paths(knight_position_,
+                                                princess_position_);
+}
+
+const LandmarkIndex& Game::build_landmark_index(int landmarks_count) {
+  landmark_index_ =
+      std::make_unique<const LandmarkIndex>(*frozen_map_, landmarks_count);
+  return *landmark_index_;
 }
 
 }  // namespace uni_course_cpp
@@ -1,27 +1,49 @@
 #pragma once
 
+#include <memory>
 #include <vector>
+#include "frozen_graph.hpp"
 #include "graph.hpp"
 #include "graph_path.hpp"
+#include "graph_traverser.hpp"
+#include "landmark_index.hpp"
 
 namespace uni_course_cpp {
 class Game {
  public:
   Game(Graph&& map, VertexId knight_position, VertexId princess_position)
-      : map_(map),
+      : map_(std::move(map)),
+        frozen_map_(std::make_unique<const FrozenGraph>(map_)),
+        graph_traverser_(std::make_unique<const GraphTraverser>(*frozen_map_)),
         knight_position_(knight_position),
         princess_position_(princess_position) {}
   // Traverse by `Distance`
   GraphPath find_shortest_path() const;
   // Traverse by `Duration`
   GraphPath find_fastest_path() const;
-  Graph map() const { return map_; }
+  // Both of the above from a single traversal, each breaking ties by the
+  // other criterion
+  GraphTraverser::BicriteriaPaths find_shortest_and_fastest_paths() const;
+
+  // Precomputes landmark bounds of the map that both searches use from
+  // then on; see `LandmarkIndex` for the `landmarks_count` trade-off
+  const LandmarkIndex& build_landmark_index(int landmarks_count);
+  // Null until `build_landmark_index` is called
+  const LandmarkIndex* landmark_index() const { return landmark_index_.get(); }
+
+  const Graph& map() const { return map_; }
+  const FrozenGraph& frozen_map() const { return *frozen_map_; }
   VertexId knight_position() const { return knight_position_; }
   VertexId princess_position() const { return princess_position_; }
 
  private:
   Graph map_;
+  // Behind pointers so that the traverser's reference to the map and its
+  // leased search buffers survive moves of the game; queries reuse both
+  std::unique_ptr<const FrozenGraph> frozen_map_;
+  std::unique_ptr<const GraphTraverser> graph_traverser_;
   VertexId knight_position_;
   VertexId princess_position_;
+  std::unique_ptr<const LandmarkIndex> landmark_index_;
 };
 }  // namespace uni_course_cpp
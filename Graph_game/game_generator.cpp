@@ -1,13 +1,14 @@
 #include "game_generator.hpp"
-#include <random>
+#include "random_generator.hpp"
 
 namespace {
+constexpr std::uint64_t kMapStream = 0;
+constexpr std::uint64_t kPrincessStream = 1;
+
 uni_course_cpp::VertexId get_random_vertex(
-    const std::vector<uni_course_cpp::VertexId>& vertices) {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_int_distribution<> distrib(0, vertices.size() - 1);
-  return vertices[distrib(gen)];
+    const std::vector<uni_course_cpp::VertexId>& vertices,
+    uni_course_cpp::RandomGenerator& random_generator) {
+  return vertices[random_generator.get_random(0, vertices.size() - 1)];
 }
 
 }  // namespace
@@ -15,11 +16,15 @@ uni_course_cpp::VertexId get_random_vertex(
 namespace uni_course_cpp {
 
 Game GameGenerator::generate() const {
+  const auto random_generator = RandomGenerator(params_.seed());
   const auto graph_generator = GraphGenerator(params_);
-  auto map = graph_generator.generate();
+  auto map = graph_generator.generate(random_generator.split(kMapStream));
   const auto& final_vertices = map.get_vertex_ids_at_depth(map.get_depth() - 1);
 
-  return Game(std::move(map), 0, get_random_vertex(final_vertices));
+  auto princess_random_generator = random_generator.split(kPrincessStream);
+  const auto princess_position =
+      get_random_vertex(final_vertices, princess_random_generator);
+  return Game(std::move(map), 0, princess_position);
 }
 
 }  // namespace uni_course_cpp
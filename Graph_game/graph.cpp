@@ -3,16 +3,12 @@
 #include <fstream>
 #include <iostream>
 
-#include <unordered_map>
-
 namespace uni_course_cpp {
 const Edge& Graph::get_edge(EdgeId id) const {
-  for (const auto& edge : edges_) {
-    if (edge.get_id() == id) {
-      return edge;
-    }
+  if (id < 0 || id >= edges_.size()) {
+    throw std::runtime_error("Edge not found!\n");
   }
-  throw std::runtime_error("Edge not found!\n");
+  return edges_[id];
 }
 
 const std::vector<Vertex>& Graph::get_vertices() const {
@@ -23,6 +19,126 @@ const std::vector<Edge>& Graph::get_edges() const {
   return edges_;
 }
 
+void Graph::reserve(int vertices_count, int edges_count) {
+  vertices_.reserve(vertices_count);
+  adjacency_list_.reserve(vertices_count);
+  neighbor_ids_.reserve(vertices_count);
+  vertices_depth_.reserve(vertices_count);
+  depth_positions_.reserve(vertices_count);
+  edges_.reserve(edges_count);
+}
+
+int Graph::GreyBranch::add_vertex(int parent_index, Edge::Duration duration) {
+  const Depth level =
+      parent_index == kRootIndex ? 0 : levels_[parent_index] + 1;
+  if (level_sizes_.size() < level + 1) {
+    level_sizes_.resize(level + 1);
+  }
+  level_sizes_[level]++;
+  parent_indices_.push_back(parent_index);
+  durations_.push_back(duration);
+  levels_.push_back(level);
+  return parent_indices_.size() - 1;
+}
+
+std::vector<Graph::BranchPlacement> Graph::place_grey_branches(
+    VertexId root_vertex_id,
+    const std::vector<GreyBranch>& branches) {
+  const auto first_level = get_vertex_depth(root_vertex_id) + 1;
+  int new_vertices_count = 0;
+  Depth levels_count = 0;
+  for (const auto& branch : branches) {
+    new_vertices_count += branch.size();
+    levels_count = std::max<Depth>(levels_count, branch.level_sizes_.size());
+  }
+  if (depth_map_.size() < first_level + levels_count) {
+    depth_map_.resize(first_level + levels_count);
+  }
+
+  std::vector<BranchPlacement> placements;
+  placements.reserve(branches.size());
+  auto& grey_edge_ids = colored_edges_[static_cast<int>(Edge::Color::Grey)];
+  auto next_vertex_id = vertex_id_counter_;
+  auto next_edge_id = edge_id_counter_;
+  int next_grey_edges_offset = grey_edge_ids.size();
+  std::vector<int> level_ends(levels_count);
+  for (Depth level = 0; level < levels_count; ++level) {
+    level_ends[level] = depth_map_[first_level + level].size();
+  }
+  for (const auto& branch : branches) {
+    auto& placement = placements.emplace_back();
+    placement.root_vertex_id = root_vertex_id;
+    placement.first_vertex_id = next_vertex_id;
+    placement.first_edge_id = next_edge_id;
+    placement.grey_edges_offset = next_grey_edges_offset;
+    placement.level_offsets.assign(level_ends.begin(),
+                                   level_ends.begin() +
+                                       branch.level_sizes_.size());
+    for (Depth level = 0; level < branch.level_sizes_.size(); ++level) {
+      level_ends[level] += branch.level_sizes_[level];
+    }
+    for (int index = 0; index < branch.size(); ++index) {
+      if (branch.parent_indices_[index] == GreyBranch::kRootIndex) {
+        adjacency_list_[root_vertex_id].push_back(next_edge_id + index);
+        add_neighbor(root_vertex_id, next_vertex_id + index);
+      }
+    }
+    next_vertex_id += branch.size();
+    next_edge_id += branch.size();
+    next_grey_edges_offset += branch.size();
+  }
+
+  for (Depth level = 0; level < levels_count; ++level) {
+    depth_map_[first_level + level].resize(level_ends[level]);
+  }
+  const auto vertices_count = vertex_id_counter_ + new_vertices_count;
+  vertices_.resize(vertices_count, Vertex(0));
+  adjacency_list_.resize(vertices_count);
+  neighbor_ids_.resize(vertices_count);
+  vertices_depth_.resize(vertices_count);
+  depth_positions_.resize(vertices_count);
+  edges_.resize(edge_id_counter_ + new_vertices_count,
+                Edge(0, 0, 0, Edge::Color::Grey, 0));
+  grey_edge_ids.resize(next_grey_edges_offset);
+  vertex_id_counter_ = next_vertex_id;
+  edge_id_counter_ = next_edge_id;
+  return placements;
+}
+
+void Graph::splice_grey_branch(const GreyBranch& branch,
+                               const BranchPlacement& placement) {
+  const auto first_level = get_vertex_depth(placement.root_vertex_id) + 1;
+  auto level_positions = placement.level_offsets;
+  auto& grey_edge_ids = colored_edges_[static_cast<int>(Edge::Color::Grey)];
+
+  for (int index = 0; index < branch.size(); ++index) {
+    const VertexId vertex_id = placement.first_vertex_id + index;
+    const EdgeId edge_id = placement.first_edge_id + index;
+    const auto parent_index = branch.parent_indices_[index];
+    const VertexId parent_id = parent_index == GreyBranch::kRootIndex
+                                   ? placement.root_vertex_id
+                                   : placement.first_vertex_id + parent_index;
+    const auto level = branch.levels_[index];
+
+    vertices_[vertex_id] = Vertex(vertex_id);
+    edges_[edge_id] = Edge(edge_id, parent_id, vertex_id, Edge::Color::Grey,
+                           branch.durations_[index]);
+    grey_edge_ids[placement.grey_edges_offset + index] = edge_id;
+    vertices_depth_[vertex_id] = first_level + level;
+    depth_positions_[vertex_id] = level_positions[level];
+    depth_map_[first_level + level][level_positions[level]++] = vertex_id;
+
+    // Children always come after their parent, so both lists stay in the
+    // order (and, for neighbors, the sorted order) that add_edge produces
+    adjacency_list_[vertex_id].push_back(edge_id);
+    neighbor_ids_[vertex_id].push_back(parent_id);
+    if (parent_index != GreyBranch::kRootIndex) {
+      adjacency_list_[parent_id].push_back(edge_id);
+      neighbor_ids_[parent_id].push_back(vertex_id);
+    }
+  }
+}
+
 Vertex Graph::add_vertex() {
   const Vertex& vertex = vertices_.emplace_back(get_new_vertex_id());
   if (vertex.get_id() == 0) {
@@ -30,8 +146,10 @@ Vertex Graph::add_vertex() {
   } else {
     depth_map_[0].push_back(vertex.get_id());
   }
-  vertices_depth_[vertex.get_id()] = 0;
-  adjacency_list_[vertex.get_id()] = {};
+  vertices_depth_.push_back(0);
+  depth_positions_.push_back(depth_map_[0].size() - 1);
+  adjacency_list_.emplace_back();
+  neighbor_ids_.emplace_back();
   return vertex;
 }
 
@@ -43,44 +161,52 @@ EdgeId Graph::get_new_edge_id() {
 }
 
 Vertex& Graph::get_vertex(const VertexId& id) {
-  for (auto& vertex : vertices_) {
-    if (vertex.get_id() == id) {
-      return vertex;
-    }
+  if (id < 0 || id >= vertices_.size()) {
+    throw std::runtime_error("Vertex not found!\n");
   }
-  throw std::runtime_error("Vertex not found!\n");
+  return vertices_[id];
 }
 
 Graph::Depth Graph::get_vertex_depth(VertexId vertex_id) const {
   return vertices_depth_.at(vertex_id);
 }
 
-void Graph::add_edge(VertexId first_vertex_id, VertexId second_vertex_id) {
+void Graph::set_vertex_depth(VertexId vertex_id, Depth depth) {
+  // Swap-and-pop keeps removal from the old level O(1)
+  auto& old_level = depth_map_[vertices_depth_[vertex_id]];
+  const auto position = depth_positions_[vertex_id];
+  old_level[position] = old_level.back();
+  depth_positions_[old_level[position]] = position;
+  old_level.pop_back();
+
+  if (depth_map_.size() < depth + 1) {
+    depth_map_.resize(depth + 1);
+  }
+  vertices_depth_[vertex_id] = depth;
+  depth_positions_[vertex_id] = depth_map_[depth].size();
+  depth_map_[depth].push_back(vertex_id);
+}
+
+void Graph::add_edge(VertexId first_vertex_id,
+                     VertexId second_vertex_id,
+                     RandomGenerator& random_generator) {
+  const auto& first_vertex = get_vertex(first_vertex_id);
+  const auto& second_vertex = get_vertex(second_vertex_id);
   Edge::Color color = get_edge_color(first_vertex_id, second_vertex_id);
-  const auto& new_edge = edges_.emplace_back(get_new_edge_id(), first_vertex_id,
-                                             second_vertex_id, color);
+  const auto& new_edge = edges_.emplace_back(
+      get_new_edge_id(), first_vertex_id, second_vertex_id, color,
+      Edge::get_random_duration(color, random_generator));
 
-  auto& first_vertex = get_vertex(first_vertex_id);
   adjacency_list_[first_vertex_id].push_back(new_edge.get_id());
-  auto& second_vertex = get_vertex(second_vertex_id);
+  add_neighbor(first_vertex_id, second_vertex_id);
   if (second_vertex.get_id() != first_vertex.get_id()) {
     adjacency_list_[second_vertex_id].push_back(new_edge.get_id());
+    add_neighbor(second_vertex_id, first_vertex_id);
   }
   if (color == Edge::Color::Grey) {
-    vertices_depth_[second_vertex_id] = get_vertex_depth(first_vertex_id) + 1;
-    if (depth_map_.size() < get_vertex_depth(first_vertex.get_id()) + 2) {
-      depth_map_.push_back({second_vertex_id});
-    } else {
-      depth_map_[get_vertex_depth(first_vertex.get_id()) + 1].push_back(
-          second_vertex_id);
-    }
-    auto depth_iterator =
-        std::find(depth_map_[0].begin(), depth_map_[0].end(), second_vertex_id);
-    if (depth_iterator != depth_map_[0].end()) {
-      depth_map_[0].erase(depth_iterator);
-    }
+    set_vertex_depth(second_vertex_id, get_vertex_depth(first_vertex_id) + 1);
   }
-  colored_edges_[color].push_back(new_edge.get_id());
+  colored_edges_[static_cast<int>(color)].push_back(new_edge.get_id());
 }
 Edge::Color Graph::get_edge_color(VertexId from_vertex_id,
                                   VertexId to_vertex_id) {
@@ -103,29 +229,24 @@ Edge::Color Graph::get_edge_color(VertexId from_vertex_id,
   throw std::runtime_error("Failed to determine color");
 }
 
-bool Graph::is_connected(VertexId from_vertex_id, VertexId to_vertex_id) const {
-  for (const auto& connected_edge : adjacency_list_.at(from_vertex_id)) {
-    if (get_edge(connected_edge).get_color() == Edge::Color::Green &&
-        from_vertex_id == to_vertex_id) {
-      return true;
-    }
-    const Edge& edge = get_edge(connected_edge);
-    if ((edge.get_first_vertex_id() == to_vertex_id ||
-         edge.get_second_vertex_id() == to_vertex_id) &&
-        to_vertex_id != from_vertex_id) {
-      return true;
-    }
+void Graph::add_neighbor(VertexId vertex_id, VertexId neighbor_id) {
+  auto& neighbor_ids = neighbor_ids_[vertex_id];
+  const auto position =
+      std::lower_bound(neighbor_ids.begin(), neighbor_ids.end(), neighbor_id);
+  if (position == neighbor_ids.end() || *position != neighbor_id) {
+    neighbor_ids.insert(position, neighbor_id);
   }
-  return false;
+}
+
+bool Graph::is_connected(VertexId from_vertex_id, VertexId to_vertex_id) const {
+  const auto& neighbor_ids = neighbor_ids_.at(from_vertex_id);
+  return std::binary_search(neighbor_ids.begin(), neighbor_ids.end(),
+                            to_vertex_id);
 }
 
 const std::vector<EdgeId>& Graph::get_colored_edge_ids(
     const Edge::Color& color) const {
-  if (colored_edges_.find(color) == colored_edges_.end()) {
-    static const std::vector<EdgeId> empty_result = {};
-    return empty_result;
-  }
-  return colored_edges_.at(color);
+  return colored_edges_[static_cast<int>(color)];
 }
 
 }  // namespace uni_course_cpp
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <unordered_map>
+#include <array>
+#include <vector>
 
 #include "edge.hpp"
 #include "vertex.hpp"
@@ -10,10 +11,55 @@ class Graph {
  public:
   using Depth = int;
 
+  // Grey subtree built outside of the graph, with vertices numbered
+  // locally in creation order. Real ids are assigned when it is spliced.
+  class GreyBranch {
+   public:
+    static constexpr int kRootIndex = -1;
+
+    // `parent_index` is an earlier vertex of this branch or `kRootIndex`
+    int add_vertex(int parent_index, Edge::Duration duration);
+    int size() const { return parent_indices_.size(); }
+
+   private:
+    friend class Graph;
+    std::vector<int> parent_indices_;
+    std::vector<Edge::Duration> durations_;
+    // Depth below the root vertex, starting from 0 for its children
+    std::vector<Depth> levels_;
+    std::vector<int> level_sizes_;
+  };
+
+  // Id ranges and depth map slots reserved for one `GreyBranch`
+  struct BranchPlacement {
+    VertexId root_vertex_id = 0;
+    VertexId first_vertex_id = 0;
+    EdgeId first_edge_id = 0;
+    int grey_edges_offset = 0;
+    std::vector<int> level_offsets;
+  };
+
+  // Vertex and edge ids are dense (0, 1, 2, ...), so every per-id table
+  // below is a plain vector and all lookups and insertions are O(1).
   Vertex add_vertex();
-  void add_edge(VertexId first_vertex_id, VertexId second_vertex_id);
+  // The edge duration is drawn from `random_generator`
+  void add_edge(VertexId first_vertex_id,
+                VertexId second_vertex_id,
+                RandomGenerator& random_generator);
+  void reserve(int vertices_count, int edges_count);
+
+  // Two-phase bulk insertion of grey subtrees under `root_vertex_id`:
+  // `place_grey_branches` assigns consecutive id ranges in branch order and
+  // links the root, then `splice_grey_branch` fills in one branch. Splices
+  // of different branches touch disjoint memory and may run concurrently.
+  std::vector<BranchPlacement> place_grey_branches(
+      VertexId root_vertex_id,
+      const std::vector<GreyBranch>& branches);
+  void splice_grey_branch(const GreyBranch& branch,
+                          const BranchPlacement& placement);
 
   const std::vector<Vertex>& get_vertices() const;
+  int vertices_count() const { return vertices_.size(); }
   const std::vector<Edge>& get_edges() const;
   const Edge& get_edge(EdgeId id) const;
   const std::vector<VertexId>& get_vertex_ids_at_depth(Depth depth) const {
@@ -37,17 +83,23 @@ class Graph {
   std::vector<Vertex> vertices_;
   std::vector<Edge> edges_;
 
-  std::unordered_map<VertexId, std::vector<EdgeId>> adjacency_list_;
-  std::unordered_map<VertexId, Depth> vertices_depth_;
+  std::vector<std::vector<EdgeId>> adjacency_list_;
+  // Sorted, duplicate-free neighbors of each vertex (itself for a loop)
+  std::vector<std::vector<VertexId>> neighbor_ids_;
+  std::vector<Depth> vertices_depth_;
+  // Index of each vertex inside `depth_map_[vertices_depth_[id]]`
+  std::vector<int> depth_positions_;
 
   Edge::Color get_edge_color(VertexId from_vertex_id, VertexId to_vertex_id);
 
   Vertex& get_vertex(const VertexId& id);
+  void add_neighbor(VertexId vertex_id, VertexId neighbor_id);
+  void set_vertex_depth(VertexId vertex_id, Depth depth);
 
   VertexId vertex_id_counter_ = 0;
   EdgeId edge_id_counter_ = 0;
   std::vector<std::vector<VertexId>> depth_map_;
-  std::unordered_map<Edge::Color, std::vector<EdgeId>> colored_edges_;
+  std::array<std::vector<EdgeId>, 4> colored_edges_;
 };
 
 }  // namespace uni_course_cpp
@@ -1,201 +1,377 @@
 #include "graph_generator.hpp"
-#include <atomic>
-#include <functional>
+#include <deque>
 #include <iostream>
-#include <list>
-#include <mutex>
-#include <random>
-#include <thread>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "thread_pool.hpp"
 
 namespace {
 constexpr double kGreenProbability = 0.1;
 constexpr double kRedProbability = 0.33;
-const int kMaxThreadCount = std::thread::hardware_concurrency();
+constexpr int kChunkSize = 1024;
 
-bool check_probability(double probability) {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::bernoulli_distribution d(probability);
-  return d(gen);
-}
+// Stream ids for `RandomGenerator::split`, one per generation phase
+enum class Stream { Grey, Green, Yellow, Red, Commit };
 
-int get_random_index(int size) {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_int_distribution<> distrib(0, size);
-  return distrib(gen);
+uni_course_cpp::RandomGenerator get_stream(
+    const uni_course_cpp::RandomGenerator& random_generator,
+    Stream stream) {
+  return random_generator.split(static_cast<std::uint64_t>(stream));
 }
-}  // namespace
-namespace uni_course_cpp {
-
-void GraphGenerator::generate_grey_edges(Graph& graph) const {
-  using JobCallback = std::function<void()>;
-  auto jobs = std::list<JobCallback>();
-  std::mutex mutex;
-  std::atomic<bool> check_termination = false;
-  std::atomic<int> jobs_done = 0;
-  for (int job_number = 0; job_number < params_.new_vertices_count();
-       job_number++) {
-    jobs.push_back([&jobs_done, &mutex, &graph, this]() {
-      generate_grey_branch(graph, 0, 0, mutex);
-      jobs_done++;
-    });
-  }
-  const auto worker = [&check_termination, &mutex, &jobs]() {
-    while (true) {
-      if (check_termination) {
-        return;
-      }
-
-      const auto optional_job = [&jobs,
-                                 &mutex]() -> std::optional<JobCallback> {
-        const std::lock_guard<std::mutex> lock(mutex);
-        if (jobs.size() > 0) {
-          const auto job = jobs.back();
-          jobs.pop_back();
-          return job;
-        }
-        return std::nullopt;
-      }();
 
-      if (optional_job.has_value()) {
-        const auto& job = optional_job.value();
-        job();
-      }
+// Uniform pick among the vertices at `depth` that are not adjacent to
+// `vertex_id`. A vertex has only a few neighbors on any level, so rejection
+// sampling beats materializing the whole set difference.
+std::optional<uni_course_cpp::VertexId> get_random_unconnected_vertex_id(
+    const uni_course_cpp::Graph& graph,
+    uni_course_cpp::VertexId vertex_id,
+    uni_course_cpp::Graph::Depth depth,
+    uni_course_cpp::RandomGenerator& random_generator) {
+  const auto& candidate_ids = graph.get_vertex_ids_at_depth(depth);
+  int connected_count = 0;
+  for (const auto edge_id : graph.get_connected_edges_ids(vertex_id)) {
+    const auto& edge = graph.get_edge(edge_id);
+    const auto neighbor_id =
+        edge.get_first_vertex_id() + edge.get_second_vertex_id() - vertex_id;
+    if (neighbor_id != vertex_id &&
+        graph.get_vertex_depth(neighbor_id) == depth) {
+      connected_count++;
     }
-  };
-
-  const auto thread_count =
-      std::min(kMaxThreadCount, params_.new_vertices_count());
-  auto threads = std::vector<std::thread>();
-  threads.reserve(thread_count);
-  for (int thread_num = 0; thread_num < thread_count; ++thread_num) {
-    threads.push_back(std::thread(worker));
   }
-  while (jobs_done < params_.new_vertices_count()) {
+  if (connected_count >= candidate_ids.size()) {
+    return std::nullopt;
   }
-  check_termination = true;
-  for (auto& thread : threads) {
-    thread.join();
+  while (true) {
+    const auto candidate_id =
+        candidate_ids[random_generator.get_random(0, candidate_ids.size() - 1)];
+    if (!graph.is_connected(vertex_id, candidate_id)) {
+      return candidate_id;
+    }
   }
 }
 
-void GraphGenerator::generate_grey_branch(Graph& graph,
-                                          Graph::Depth depth,
-                                          const VertexId& vertex_id,
-                                          std::mutex& mutex) const {
+// Depth level resident in the streaming generator. Ids on a level are
+// consecutive, and so are the ids of each vertex's children on the next one.
+struct StreamedLevel {
+  uni_course_cpp::VertexId first_vertex_id = 0;
+  std::vector<std::vector<uni_course_cpp::EdgeId>> connected_edge_ids;
+  std::vector<uni_course_cpp::VertexId> children_begin;
+  std::vector<uni_course_cpp::VertexId> children_end;
+
+  int size() const { return connected_edge_ids.size(); }
+  bool contains(uni_course_cpp::VertexId vertex_id) const {
+    return vertex_id >= first_vertex_id && vertex_id < first_vertex_id + size();
+  }
+};
+}  // namespace
+namespace uni_course_cpp {
+
+void GraphGenerator::generate_grey_edges(
+    Graph& graph,
+    const RandomGenerator& random_generator) const {
+  // Every job grows its subtree privately and lock-free, then the subtrees
+  // are spliced in parallel once their id ranges are known
+  auto branches = std::vector<Graph::GreyBranch>(params_.new_vertices_count());
+  auto& thread_pool = ThreadPool::get_thread_pool();
+  thread_pool.parallel_for(
+      0, branches.size(),
+      [&branches, &random_generator, this](int job_number) {
+        auto job_random_generator = random_generator.split(job_number);
+        generate_grey_branch(branches[job_number], 0,
+                             Graph::GreyBranch::kRootIndex,
+                             job_random_generator);
+      },
+      params_.threads_count());
+
+  const auto placements = graph.place_grey_branches(0, branches);
+  thread_pool.parallel_for(
+      0, branches.size(),
+      [&graph, &branches, &placements](int job_number) {
+        graph.splice_grey_branch(branches[job_number], placements[job_number]);
+      },
+      params_.threads_count());
+}
+
+void GraphGenerator::generate_grey_branch(
+    Graph::GreyBranch& branch,
+    Graph::Depth depth,
+    int parent_index,
+    RandomGenerator& random_generator) const {
   if (depth >= params_.depth() - 1) {
     return;
   }
-  if (!check_probability(1.0 - (double)depth / (double)params_.depth())) {
+  if (!random_generator.check_probability(1.0 - (double)depth /
+                                                    (double)params_.depth())) {
     return;
   }
 
-  const auto& new_vertex = [&graph, &mutex, &vertex_id]() {
-    const std::lock_guard<std::mutex> lock(mutex);
-    const auto& added_vertex = graph.add_vertex();
-    graph.add_edge(vertex_id, added_vertex.get_id());
-    return added_vertex;
-  }();
+  const auto new_vertex_index = branch.add_vertex(
+      parent_index,
+      Edge::get_random_duration(Edge::Color::Grey, random_generator));
   for (int job_number = 0; job_number < params_.new_vertices_count();
        ++job_number) {
-    generate_grey_branch(graph, depth + 1, new_vertex.get_id(), mutex);
+    generate_grey_branch(branch, depth + 1, new_vertex_index,
+                         random_generator);
   }
 }
 
-void GraphGenerator::generate_green_edges(Graph& graph,
-                                          std::mutex& mutex) const {
-  for (const auto& vertex : graph.get_vertices()) {
-    if (check_probability(kGreenProbability)) {
-      const std::lock_guard<std::mutex> lock(mutex);
-      graph.add_edge(vertex.get_id(), vertex.get_id());
+void GraphGenerator::generate_colored_edges(
+    Graph& graph,
+    const RandomGenerator& random_generator) const {
+  // Levels are cut into fixed-size chunks, each with its own random
+  // streams, so the result does not depend on the number of workers
+  struct Chunk {
+    ArrayView<VertexId> vertex_ids;
+    EdgeCandidates green_edges{};
+    EdgeCandidates yellow_edges{};
+    EdgeCandidates red_edges{};
+  };
+  auto chunks = std::vector<Chunk>();
+  for (Graph::Depth depth = 0; depth < graph.get_depth(); ++depth) {
+    const auto& vertex_ids = graph.get_vertex_ids_at_depth(depth);
+    for (int begin = 0; begin < vertex_ids.size(); begin += kChunkSize) {
+      const int size = std::min<int>(kChunkSize, vertex_ids.size() - begin);
+      chunks.push_back({ArrayView<VertexId>(vertex_ids.data() + begin, size)});
+    }
+  }
+
+  const Graph& const_graph = graph;
+  ThreadPool::get_thread_pool().parallel_for(
+      0, chunks.size(),
+      [&const_graph, &chunks, &random_generator, this](int chunk_index) {
+        auto& chunk = chunks[chunk_index];
+        generate_green_edges(
+            chunk.vertex_ids,
+            get_stream(random_generator, Stream::Green).split(chunk_index),
+            chunk.green_edges);
+        generate_yellow_edges(
+            const_graph, chunk.vertex_ids,
+            get_stream(random_generator, Stream::Yellow).split(chunk_index),
+            chunk.yellow_edges);
+        generate_red_edges(
+            const_graph, chunk.vertex_ids,
+            get_stream(random_generator, Stream::Red).split(chunk_index),
+            chunk.red_edges);
+      },
+      params_.threads_count());
+
+  // Candidates never affect each other's color, so committing them color by
+  // color in chunk order gives the same graph as sequential generation
+  auto commit_random_generator = get_stream(random_generator, Stream::Commit);
+  for (const auto member :
+       {&Chunk::green_edges, &Chunk::yellow_edges, &Chunk::red_edges}) {
+    for (const auto& chunk : chunks) {
+      for (const auto& [first_vertex_id, second_vertex_id] : chunk.*member) {
+        graph.add_edge(first_vertex_id, second_vertex_id,
+                       commit_random_generator);
+      }
     }
   }
 }
-std::vector<VertexId> get_unconected_vertex_ids(
-    const Graph& graph,
-    const Vertex& vertex,
-    const std::vector<VertexId>& vertices_at_depth,
-    std::mutex& mutex) {
-  std::vector<VertexId> vertices_ids;
-  const auto vertex_id = vertex.get_id();
-  for (const auto& another_vertex : vertices_at_depth) {
-    const auto is_connected_bool = [&graph, &vertex_id, &another_vertex,
-                                    &mutex]() {
-      const std::lock_guard<std::mutex> lock(mutex);
-      return graph.is_connected(vertex_id, another_vertex);
-    }();
-
-    if (!is_connected_bool) {
-      vertices_ids.push_back(another_vertex);
+
+void GraphGenerator::generate_green_edges(
+    ArrayView<VertexId> vertex_ids,
+    RandomGenerator random_generator,
+    EdgeCandidates& candidates) const {
+  for (const auto vertex_id : vertex_ids) {
+    if (random_generator.check_probability(kGreenProbability)) {
+      candidates.emplace_back(vertex_id, vertex_id);
     }
   }
-  return vertices_ids;
 }
 
-void GraphGenerator::generate_yellow_edges(Graph& graph,
-                                           std::mutex& mutex) const {
-  for (const auto& first_vertex : graph.get_vertices()) {
-    if (graph.get_vertex_depth(first_vertex.get_id()) >=
-        graph.get_depth() - 1) {
+void GraphGenerator::generate_yellow_edges(
+    const Graph& graph,
+    ArrayView<VertexId> vertex_ids,
+    RandomGenerator random_generator,
+    EdgeCandidates& candidates) const {
+  for (const auto first_vertex_id : vertex_ids) {
+    const auto depth = graph.get_vertex_depth(first_vertex_id);
+    if (depth >= graph.get_depth() - 1) {
       continue;
     }
 
-    if (check_probability(
-            (double)graph.get_vertex_depth(first_vertex.get_id()) /
-            ((double)params_.depth() - 1.0))) {
-      const auto unconnected_vertex_ids = get_unconected_vertex_ids(
-          graph, first_vertex,
-          graph.get_vertex_ids_at_depth(
-              graph.get_vertex_depth(first_vertex.get_id()) + 1),
-          mutex);
-
-      if (unconnected_vertex_ids.size() > 0) {
-        const VertexId second_vertex_id =
-            unconnected_vertex_ids[get_random_index(
-                unconnected_vertex_ids.size() - 1)];
-        const std::lock_guard<std::mutex> lock(mutex);
-        graph.add_edge(first_vertex.get_id(), second_vertex_id);
+    if (random_generator.check_probability((double)depth /
+                                           ((double)params_.depth() - 1.0))) {
+      const auto second_vertex_id = get_random_unconnected_vertex_id(
+          graph, first_vertex_id, depth + 1, random_generator);
+      if (second_vertex_id.has_value()) {
+        candidates.emplace_back(first_vertex_id, second_vertex_id.value());
       }
     }
   }
 }
-void GraphGenerator::generate_red_edges(Graph& graph, std::mutex& mutex) const {
-  for (const auto& first_vertex : graph.get_vertices()) {
-    if (graph.get_vertex_depth(first_vertex.get_id()) >=
-        graph.get_depth() - 2) {
+
+void GraphGenerator::generate_red_edges(const Graph& graph,
+                                        ArrayView<VertexId> vertex_ids,
+                                        RandomGenerator random_generator,
+                                        EdgeCandidates& candidates) const {
+  for (const auto first_vertex_id : vertex_ids) {
+    const auto depth = graph.get_vertex_depth(first_vertex_id);
+    if (depth >= graph.get_depth() - 2) {
       continue;
     }
 
-    if (check_probability(kRedProbability)) {
+    if (random_generator.check_probability(kRedProbability)) {
       const std::vector<VertexId>& second_vertices_ids =
-          graph.get_vertex_ids_at_depth(
-              graph.get_vertex_depth(first_vertex.get_id()) + 2);
+          graph.get_vertex_ids_at_depth(depth + 2);
       if (second_vertices_ids.size() > 0) {
-        const VertexId second_vertex_id = second_vertices_ids[get_random_index(
-            second_vertices_ids.size() - 1)];
-        const std::lock_guard<std::mutex> lock(mutex);
-        graph.add_edge(first_vertex.get_id(), second_vertex_id);
+        const VertexId second_vertex_id =
+            second_vertices_ids[random_generator.get_random(
+                0, second_vertices_ids.size() - 1)];
+        candidates.emplace_back(first_vertex_id, second_vertex_id);
       }
     }
   }
 }
 
 Graph GraphGenerator::generate() const {
+  return generate(RandomGenerator(params_.seed()));
+}
+
+Graph GraphGenerator::generate(const RandomGenerator& random_generator) const {
   auto graph = Graph();
   graph.add_vertex();
-  std::mutex mutex;
-  generate_grey_edges(graph);
-  std::thread green_thread(
-      [&graph, &mutex, this]() { generate_green_edges(graph, mutex); });
-  std::thread yellow_thread(
-      [&graph, &mutex, this]() { generate_yellow_edges(graph, mutex); });
-  std::thread red_thread(
-      [&graph, &mutex, this]() { generate_red_edges(graph, mutex); });
-  green_thread.join();
-  yellow_thread.join();
-  red_thread.join();
+  generate_grey_edges(graph, get_stream(random_generator, Stream::Grey));
+  generate_colored_edges(graph, random_generator);
   return graph;
 }
 
+void GraphGenerator::generate(GraphSink& sink) const {
+  generate(sink, RandomGenerator(params_.seed()));
+}
+
+void GraphGenerator::generate(GraphSink& sink,
+                              const RandomGenerator& random_generator) const {
+  auto levels = std::deque<StreamedLevel>(1);
+  Graph::Depth first_depth = 0;
+  VertexId next_vertex_id = 1;
+  EdgeId next_edge_id = 0;
+  levels.front().connected_edge_ids.resize(1);
+
+  const auto get_connected_edge_ids =
+      [&levels](VertexId vertex_id) -> std::vector<EdgeId>& {
+    for (auto& level : levels) {
+      if (level.contains(vertex_id)) {
+        return level.connected_edge_ids[vertex_id - level.first_vertex_id];
+      }
+    }
+    throw std::runtime_error("Vertex is not resident!\n");
+  };
+  const auto add_edge = [&sink, &next_edge_id, &get_connected_edge_ids](
+                            VertexId first_vertex_id, VertexId second_vertex_id,
+                            Edge::Color color,
+                            RandomGenerator& edge_random_generator) {
+    const auto edge =
+        Edge(next_edge_id++, first_vertex_id, second_vertex_id, color,
+             Edge::get_random_duration(color, edge_random_generator));
+    get_connected_edge_ids(first_vertex_id).push_back(edge.get_id());
+    if (second_vertex_id != first_vertex_id) {
+      get_connected_edge_ids(second_vertex_id).push_back(edge.get_id());
+    }
+    sink.write_edge(edge);
+  };
+
+  const auto grow_grey_level = [&levels, &first_depth, &next_vertex_id,
+                                &add_edge, &random_generator, this]() {
+    const Graph::Depth depth = first_depth + levels.size() - 1;
+    auto& parent_level = levels.back();
+    auto& level = levels.emplace_back();
+    level.first_vertex_id = next_vertex_id;
+    parent_level.children_begin.resize(parent_level.size());
+    parent_level.children_end.resize(parent_level.size());
+    auto grey_random_generator =
+        get_stream(random_generator, Stream::Grey).split(depth);
+    for (int index = 0; index < parent_level.size(); ++index) {
+      parent_level.children_begin[index] = next_vertex_id;
+      for (int job_number = 0; job_number < params_.new_vertices_count() &&
+                               depth < params_.depth() - 1;
+           ++job_number) {
+        if (grey_random_generator.check_probability(
+                1.0 - (double)depth / (double)params_.depth())) {
+          level.connected_edge_ids.emplace_back();
+          add_edge(parent_level.first_vertex_id + index, next_vertex_id++,
+                   Edge::Color::Grey, grey_random_generator);
+        }
+      }
+      parent_level.children_end[index] = next_vertex_id;
+    }
+  };
+
+  const auto finalize_first_level = [&levels, &first_depth, &add_edge,
+                                     &random_generator, this]() {
+    const auto& level = levels[0];
+    auto green_random_generator =
+        get_stream(random_generator, Stream::Green).split(first_depth);
+    auto yellow_random_generator =
+        get_stream(random_generator, Stream::Yellow).split(first_depth);
+    auto red_random_generator =
+        get_stream(random_generator, Stream::Red).split(first_depth);
+
+    for (int index = 0; index < level.size(); ++index) {
+      const VertexId vertex_id = level.first_vertex_id + index;
+      if (green_random_generator.check_probability(kGreenProbability)) {
+        add_edge(vertex_id, vertex_id, Edge::Color::Green,
+                 green_random_generator);
+      }
+    }
+
+    if (levels.size() > 1 && levels[1].size() > 0) {
+      const auto& next_level = levels[1];
+      for (int index = 0; index < level.size(); ++index) {
+        if (!yellow_random_generator.check_probability(
+                (double)first_depth / ((double)params_.depth() - 1.0))) {
+          continue;
+        }
+        // The only neighbors on the next level are the grey children, a
+        // consecutive id range, so the unconnected pick takes a single draw
+        const auto children_begin = level.children_begin[index];
+        const auto children_count =
+            level.children_end[index] - level.children_begin[index];
+        if (children_count >= next_level.size()) {
+          continue;
+        }
+        VertexId second_vertex_id =
+            next_level.first_vertex_id +
+            yellow_random_generator.get_random(
+                0, next_level.size() - children_count - 1);
+        if (second_vertex_id >= children_begin) {
+          second_vertex_id += children_count;
+        }
+        add_edge(level.first_vertex_id + index, second_vertex_id,
+                 Edge::Color::Yellow, yellow_random_generator);
+      }
+    }
+
+    if (levels.size() > 2 && levels[2].size() > 0) {
+      const auto& second_level = levels[2];
+      for (int index = 0; index < level.size(); ++index) {
+        if (red_random_generator.check_probability(kRedProbability)) {
+          add_edge(level.first_vertex_id + index,
+                   second_level.first_vertex_id +
+                       red_random_generator.get_random(
+                           0, second_level.size() - 1),
+                   Edge::Color::Red, red_random_generator);
+        }
+      }
+    }
+  };
+
+  while (!levels.empty()) {
+    while (levels.size() < 3 && levels.back().size() > 0) {
+      grow_grey_level();
+    }
+    finalize_first_level();
+    const auto& level = levels.front();
+    for (int index = 0; index < level.size(); ++index) {
+      sink.write_vertex(Vertex(level.first_vertex_id + index), first_depth,
+                        level.connected_edge_ids[index]);
+    }
+    levels.pop_front();
+    first_depth++;
+  }
+  sink.finish();
+}
+
 }  // namespace uni_course_cpp
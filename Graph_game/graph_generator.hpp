@@ -1,6 +1,12 @@
 #pragma once
-#include <mutex>
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "array_view.hpp"
 #include "graph.hpp"
+#include "graph_sink.hpp"
+#include "random_generator.hpp"
 
 namespace uni_course_cpp {
 
@@ -8,30 +14,67 @@ class GraphGenerator {
  public:
   struct Params {
    public:
-    explicit Params(Graph::Depth depth = 0, int new_vertices_count = 0)
-        : depth_(depth), new_vertices_count_(new_vertices_count) {}
+    explicit Params(
+        Graph::Depth depth = 0,
+        int new_vertices_count = 0,
+        RandomGenerator::Seed seed = RandomGenerator::random_seed(),
+        int threads_count = std::thread::hardware_concurrency())
+        : depth_(depth),
+          new_vertices_count_(new_vertices_count),
+          seed_(seed),
+          threads_count_(std::max(threads_count, 1)) {}
 
     Graph::Depth depth() const { return depth_; }
     int new_vertices_count() const { return new_vertices_count_; }
+    RandomGenerator::Seed seed() const { return seed_; }
+    int threads_count() const { return threads_count_; }
 
    private:
     Graph::Depth depth_ = 0;
     int new_vertices_count_ = 0;
+    RandomGenerator::Seed seed_ = 0;
+    int threads_count_ = 1;
   };
 
   explicit GraphGenerator(const Params& params = Params()) : params_(params) {}
 
+  const Params& params() const { return params_; }
+
+  // Draws from `Params::seed()`
   Graph generate() const;
+  // Draws from streams split off `random_generator`, which is left untouched
+  Graph generate(const RandomGenerator& random_generator) const;
+
+  // Streaming mode: builds the graph level by level and hands every vertex
+  // and edge to `sink` as soon as it is final. Since edges only join
+  // depths d, d + 1 and d + 2, at most three levels are kept in memory.
+  // Ids are assigned breadth-first, so the graph differs from `generate`
+  // for the same seed but follows the same distribution.
+  void generate(GraphSink& sink) const;
+  void generate(GraphSink& sink, const RandomGenerator& random_generator) const;
 
  private:
-  void generate_grey_edges(Graph& graph) const;
-  void generate_green_edges(Graph& graph, std::mutex& mutex) const;
-  void generate_yellow_edges(Graph& graph, std::mutex& mutex) const;
-  void generate_red_edges(Graph& graph, std::mutex& mutex) const;
-  void generate_grey_branch(Graph& graph,
+  void generate_grey_edges(Graph& graph,
+                           const RandomGenerator& random_generator) const;
+  using EdgeCandidates = std::vector<std::pair<VertexId, VertexId>>;
+
+  void generate_colored_edges(Graph& graph,
+                              const RandomGenerator& random_generator) const;
+  void generate_green_edges(ArrayView<VertexId> vertex_ids,
+                            RandomGenerator random_generator,
+                            EdgeCandidates& candidates) const;
+  void generate_yellow_edges(const Graph& graph,
+                             ArrayView<VertexId> vertex_ids,
+                             RandomGenerator random_generator,
+                             EdgeCandidates& candidates) const;
+  void generate_red_edges(const Graph& graph,
+                          ArrayView<VertexId> vertex_ids,
+                          RandomGenerator random_generator,
+                          EdgeCandidates& candidates) const;
+  void generate_grey_branch(Graph::GreyBranch& branch,
                             Graph::Depth depth,
-                            const VertexId& vertex_id,
-                            std::mutex& mutex) const;
+                            int parent_index,
+                            RandomGenerator& random_generator) const;
   const Params params_ = Params();
 };
 
@@ -1,15 +1,21 @@
 #pragma once
 #include <string>
+#include "array_view.hpp"
+#include "frozen_graph.hpp"
 #include "graph.hpp"
 
 namespace uni_course_cpp {
 namespace printing {
 namespace json {
 std::string graph_to_string(const uni_course_cpp::Graph& graph);
+std::string graph_to_string(const uni_course_cpp::FrozenGraph& graph);
+// Streams the same text straight to `filepath` through a `JsonWriter`
+void graph_to_file(const uni_course_cpp::Graph& graph,
+                   const std::string& filepath);
 std::string vertex_to_string(
     const uni_course_cpp::Vertex& vertex,
     uni_course_cpp::Graph::Depth depth,
-    const std::vector<uni_course_cpp::EdgeId>& connected_edges);
+    uni_course_cpp::ArrayView<uni_course_cpp::EdgeId> connected_edges);
 std::string edge_to_string(const uni_course_cpp::Edge& edge);
 }  // namespace json
 }  // namespace printing
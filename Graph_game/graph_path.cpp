@@ -2,7 +2,7 @@
 
 namespace uni_course_cpp {
 GraphPath::Distance GraphPath::distance() const {
-  return edge_ids().size();
+  return edge_ids_.size();
 }
 
 }  // namespace uni_course_cpp
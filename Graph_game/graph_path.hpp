@@ -1,23 +1,27 @@
 #pragma once
 
+#include <utility>
 #include <vector>
+#include "array_view.hpp"
 #include "graph.hpp"
 
 namespace uni_course_cpp {
+// Owning, cheaply movable path. The views returned by the accessors point
+// into the path and stay valid as long as it is not moved from or destroyed.
 struct GraphPath {
  public:
   using Distance = int;
 
   Distance distance() const;
   Edge::Duration duration() const { return duration_; }
-  std::vector<VertexId> vertex_ids() const { return vertex_ids_; }
-  std::vector<EdgeId> edge_ids() const { return edge_ids_; }
+  ArrayView<VertexId> vertex_ids() const { return vertex_ids_; }
+  ArrayView<EdgeId> edge_ids() const { return edge_ids_; }
   GraphPath(Edge::Duration new_duration,
-            std::vector<VertexId>&& new_vertex_ids,
-            std::vector<EdgeId>&& new_edge_ids)
-      : duration_(new_duration),
-        vertex_ids_(new_vertex_ids),
-        edge_ids_(new_edge_ids) {}
+            std::vector<VertexId> new_vertex_ids,
+            std::vector<EdgeId> new_edge_ids)
+      : vertex_ids_(std::move(new_vertex_ids)),
+        edge_ids_(std::move(new_edge_ids)),
+        duration_(new_duration) {}
 
  private:
   std::vector<VertexId> vertex_ids_;
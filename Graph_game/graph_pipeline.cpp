@@ -0,0 +1,109 @@
+#include "graph_pipeline.hpp"
+#include <algorithm>
+#include <atomic>
+#include "graph_traverser.hpp"
+
+namespace uni_course_cpp {
+
+GraphPipeline::GraphPipeline(
+    int graphs_count,
+    const GraphGenerator::Params& graph_generator_params,
+    int threads_count,
+    int queue_capacity)
+    : graphs_count_(graphs_count),
+      graph_generator_(graph_generator_params),
+      threads_count_(std::max(threads_count, 1)),
+      queue_capacity_(queue_capacity) {}
+
+void GraphPipeline::fail(std::exception_ptr exception) {
+  {
+    const std::lock_guard lock(exception_mutex_);
+    if (!exception_) {
+      exception_ = exception;
+    }
+  }
+  for (auto* queue : queues_) {
+    queue->close();
+  }
+}
+
+void GraphPipeline::start_stage(int threads_count,
+                                BoundedQueue<Item>* output,
+                                const std::function<void()>& body) {
+  auto running_threads = std::make_shared<std::atomic<int>>(threads_count);
+  for (int thread_number = 0; thread_number < threads_count;
+       ++thread_number) {
+    threads_.emplace_back([output, body, running_threads, this]() {
+      try {
+        body();
+      } catch (...) {
+        fail(std::current_exception());
+      }
+      if (--*running_threads == 0 && output != nullptr) {
+        output->close();
+      }
+    });
+  }
+}
+
+void GraphPipeline::run(
+    const GenerationStartedCallback& generation_started_callback,
+    const GenerationFinishedCallback& generation_finished_callback,
+    const TraversalStartedCallback& traversal_started_callback,
+    const TraversalFinishedCallback& traversal_finished_callback,
+    const ExportCallback& export_callback) {
+  auto generated = BoundedQueue<Item>(queue_capacity_);
+  auto traversed = BoundedQueue<Item>(queue_capacity_);
+  queues_ = {&generated, &traversed};
+  exception_ = nullptr;
+
+  std::atomic<int> next_index = 0;
+  start_stage(threads_count_, &generated,
+              [&generated, &next_index, &generation_started_callback,
+               &generation_finished_callback, this]() {
+                for (int index = next_index++; index < graphs_count_;
+                     index = next_index++) {
+                  generation_started_callback(index);
+                  const auto random_generator =
+                      RandomGenerator(graph_generator_.params().seed())
+                          .split(index);
+                  auto graph = std::make_unique<Graph>(
+                      graph_generator_.generate(random_generator));
+                  generation_finished_callback(index, *graph);
+                  if (!generated.push({index, std::move(graph), {}})) {
+                    return;
+                  }
+                }
+              });
+
+  start_stage(threads_count_, &traversed,
+              [&generated, &traversed, &traversal_started_callback,
+               &traversal_finished_callback]() {
+                while (auto item = generated.pop()) {
+                  traversal_started_callback(item->index);
+                  item->paths = std::make_unique<ShortestPathTree>(
+                      GraphTraverser(*item->graph).find_shortest_path_tree());
+                  traversal_finished_callback(item->index, *item->paths);
+                  if (!traversed.push(std::move(*item))) {
+                    return;
+                  }
+                }
+              });
+
+  start_stage(1, nullptr, [&traversed, &export_callback]() {
+    while (auto item = traversed.pop()) {
+      export_callback(item->index, *item->graph);
+    }
+  });
+
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  queues_.clear();
+  if (exception_) {
+    std::rethrow_exception(exception_);
+  }
+}
+
+}  // namespace uni_course_cpp
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bounded_queue.hpp"
+#include "graph_generator.hpp"
+#include "shortest_path_tree.hpp"
+
+namespace uni_course_cpp {
+// Batch processing of many graphs as a pipeline of stages connected by
+// bounded queues: generation -> traversal -> export. A graph enters the next
+// stage as soon as it leaves the previous one, so stages overlap and at most
+// `queue_capacity` graphs wait between two stages. Every stage reports its
+// own events, so they are seen when they happen rather than when the graph
+// leaves the pipeline.
+class GraphPipeline {
+ public:
+  // Every callback runs on its stage's own thread(s); those of the
+  // generation and traversal stages may run concurrently for different
+  // graphs
+  using GenerationStartedCallback = std::function<void(int index)>;
+  using GenerationFinishedCallback =
+      std::function<void(int index, const Graph& graph)>;
+  using TraversalStartedCallback = std::function<void(int index)>;
+  using TraversalFinishedCallback =
+      std::function<void(int index, const ShortestPathTree& paths)>;
+  // Writes the graph out in whatever format the caller needs
+  using ExportCallback = std::function<void(int index, const Graph& graph)>;
+
+  // `threads_count` threads feed each of the generation and traversal
+  // stages; the heavy lifting inside them runs on the shared `ThreadPool`
+  GraphPipeline(int graphs_count,
+                const GraphGenerator::Params& graph_generator_params,
+                int threads_count,
+                int queue_capacity);
+
+  // Blocks until every graph has been exported. An exception thrown by any
+  // stage stops the pipeline and is rethrown here.
+  void run(const GenerationStartedCallback& generation_started_callback,
+           const GenerationFinishedCallback& generation_finished_callback,
+           const TraversalStartedCallback& traversal_started_callback,
+           const TraversalFinishedCallback& traversal_finished_callback,
+           const ExportCallback& export_callback);
+
+ private:
+  struct Item {
+    int index = 0;
+    std::unique_ptr<Graph> graph;
+    std::unique_ptr<ShortestPathTree> paths;
+  };
+
+  // Runs `body` on `threads_count` threads and closes `output`, if any,
+  // once all of them are done
+  void start_stage(int threads_count,
+                   BoundedQueue<Item>* output,
+                   const std::function<void()>& body);
+  void fail(std::exception_ptr exception);
+
+  const int graphs_count_;
+  const GraphGenerator graph_generator_;
+  const int threads_count_;
+  const int queue_capacity_;
+  std::vector<std::thread> threads_;
+  std::vector<BoundedQueue<Item>*> queues_;
+  std::mutex exception_mutex_;
+  std::exception_ptr exception_;
+};
+}  // namespace uni_course_cpp
@@ -2,6 +2,7 @@
 #include <array>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 namespace uni_course_cpp {
 namespace printing {
@@ -53,17 +54,62 @@ std::string print_graph(const uni_course_cpp::Graph& graph) {
 std::string print_path(const GraphPath& path) {
   std::stringstream path_string;
   path_string << "{vertices: [";
-  for (const auto vertex_id : path.vertex_ids()) {
-    path_string << vertex_id;
-    if (vertex_id != path.vertex_ids()[path.vertex_ids().size() - 1]) {
+  const auto vertex_ids = path.vertex_ids();
+  for (int index = 0; index < vertex_ids.size(); ++index) {
+    if (index != 0) {
       path_string << ", ";
     }
+    path_string << vertex_ids[index];
   }
-  path_string << "], distance: " << path.edge_ids().size()
+  path_string << "], distance: " << path.distance()
               << ", duration: " << path.duration() << "}";
   return path_string.str();
 }
 
+std::string print_path(const CompactGraphPath& path) {
+  std::vector<VertexId> vertex_ids;
+  vertex_ids.reserve(path.distance() + 1);
+  path.for_each_vertex_backward(
+      [&vertex_ids](VertexId vertex_id) { vertex_ids.push_back(vertex_id); });
+  std::stringstream path_string;
+  path_string << "{vertices: [";
+  for (int index = vertex_ids.size() - 1; index >= 0; --index) {
+    path_string << vertex_ids[index];
+    if (index != 0) {
+      path_string << ", ";
+    }
+  }
+  path_string << "], distance: " << path.distance()
+              << ", duration: " << path.duration() << "}";
+  return path_string.str();
+}
+
+std::string print_shortest_path_tree(const ShortestPathTree& tree) {
+  std::stringstream tree_string;
+  tree_string << "{source: " << tree.source_vertex_id() << ", targets: [";
+  const auto& target_vertex_ids = tree.target_vertex_ids();
+  for (int index = 0; index < target_vertex_ids.size(); ++index) {
+    if (index != 0) {
+      tree_string << ", ";
+    }
+    tree_string << target_vertex_ids[index];
+  }
+  tree_string << "], parents: {";
+  bool is_first = true;
+  for (const auto vertex_id : tree.get_path_vertex_ids()) {
+    if (vertex_id == tree.source_vertex_id()) {
+      continue;
+    }
+    if (!is_first) {
+      tree_string << ", ";
+    }
+    is_first = false;
+    tree_string << vertex_id << ": " << tree.tree().get_parent_id(vertex_id);
+  }
+  tree_string << "}}";
+  return tree_string.str();
+}
+
 std::string print_game(const uni_course_cpp::Game& game) {
   std::stringstream result;
   result << "{\n  map:\n"
@@ -3,12 +3,18 @@
 #include "game.hpp"
 #include "graph.hpp"
 #include "graph_path.hpp"
+#include "predecessor_tree.hpp"
+#include "shortest_path_tree.hpp"
 
 namespace uni_course_cpp {
 namespace printing {
 std::string color_to_string(const uni_course_cpp::Edge::Color& color);
 std::string print_graph(const uni_course_cpp::Graph& graph);
 std::string print_path(const GraphPath& path);
+std::string print_path(const CompactGraphPath& path);
+// Targets and the parent of every vertex on a path to one of them, so the
+// output grows with the tree rather than with targets times depth
+std::string print_shortest_path_tree(const ShortestPathTree& tree);
 std::string print_game(const uni_course_cpp::Game& game);
 
 }  // namespace printing
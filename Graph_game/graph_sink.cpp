@@ -0,0 +1,58 @@
+#include "graph_sink.hpp"
+#include <cstdio>
+#include <stdexcept>
+
+namespace uni_course_cpp {
+
+JsonGraphSink::JsonGraphSink(const std::string& filepath)
+    : filepath_(filepath),
+      edges_filepath_(filepath + ".edges"),
+      file_(filepath_) {
+  edges_file_.emplace(edges_filepath_);
+  file_.write("{\n\"vertices\": [\n");
+}
+
+JsonGraphSink::~JsonGraphSink() {
+  if (!is_finished_) {
+    edges_file_.reset();
+    std::remove(edges_filepath_.c_str());
+  }
+}
+
+void JsonGraphSink::write_vertex(const Vertex& vertex,
+                                 Graph::Depth depth,
+                                 ArrayView<EdgeId> connected_edge_ids) {
+  if (has_vertices_) {
+    file_.write(",\n");
+  }
+  has_vertices_ = true;
+  file_.write_vertex(vertex, depth, connected_edge_ids);
+}
+
+void JsonGraphSink::write_edge(const Edge& edge) {
+  if (has_edges_) {
+    edges_file_->write(",\n");
+  }
+  has_edges_ = true;
+  edges_file_->write_edge(edge);
+}
+
+void JsonGraphSink::finish() {
+  file_.write("\n],\n\"edges\": [\n");
+  edges_file_->close();
+  edges_file_.reset();
+  if (has_edges_) {
+    std::FILE* const edges_file = std::fopen(edges_filepath_.c_str(), "rb");
+    if (edges_file == nullptr) {
+      throw std::runtime_error("Can't open " + edges_filepath_ + " file");
+    }
+    file_.copy_from(edges_file);
+    std::fclose(edges_file);
+  }
+  std::remove(edges_filepath_.c_str());
+  file_.write("\n]\n}\n");
+  file_.close();
+  is_finished_ = true;
+}
+
+}  // namespace uni_course_cpp
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include "array_view.hpp"
+#include "graph.hpp"
+#include "json_writer.hpp"
+
+namespace uni_course_cpp {
+// Receiver of a graph that is produced piece by piece, e.g. by the
+// streaming mode of `GraphGenerator`
+class GraphSink {
+ public:
+  virtual ~GraphSink() = default;
+
+  // Called once per vertex, in id order, after all its edges are known
+  virtual void write_vertex(const Vertex& vertex,
+                            Graph::Depth depth,
+                            ArrayView<EdgeId> connected_edge_ids) = 0;
+  // Called once per edge, in id order, as soon as it is created
+  virtual void write_edge(const Edge& edge) = 0;
+  virtual void finish() = 0;
+};
+
+// Writes the same JSON as `printing::json::graph_to_string`. Vertices go
+// straight to `filepath`, edges are spooled to a side file and appended by
+// `finish`, so memory use does not grow with the graph.
+class JsonGraphSink : public GraphSink {
+ public:
+  explicit JsonGraphSink(const std::string& filepath);
+  ~JsonGraphSink() override;
+
+  void write_vertex(const Vertex& vertex,
+                    Graph::Depth depth,
+                    ArrayView<EdgeId> connected_edge_ids) override;
+  void write_edge(const Edge& edge) override;
+  void finish() override;
+
+ private:
+  std::string filepath_;
+  std::string edges_filepath_;
+  printing::json::JsonWriter file_;
+  // Reset to close it early, before the side file is deleted
+  std::optional<printing::json::JsonWriter> edges_file_;
+  bool has_vertices_ = false;
+  bool has_edges_ = false;
+  bool is_finished_ = false;
+};
+}  // namespace uni_course_cpp
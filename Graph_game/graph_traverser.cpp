@@ -1,173 +1,770 @@
 #include "graph_traverser.hpp"
-#include <atomic>
+#include <algorithm>
 #include <cassert>
 #include <climits>
-#include <functional>
-#include <list>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
 #include <mutex>
-#include <queue>
-#include <thread>
-#include <unordered_map>
+#include <stdexcept>
 #include <vector>
 #include "graph.hpp"
+#include "thread_pool.hpp"
 
 namespace {
-constexpr uni_course_cpp::GraphPath::Distance MAX_DISTANCE = INT_MAX;
-constexpr uni_course_cpp::Edge::Duration MAX_DURATION = INT_MAX;
+constexpr uni_course_cpp::GraphPath::Distance MAX_DISTANCE =
+    uni_course_cpp::traversal::kMaxCost;
+constexpr uni_course_cpp::Edge::Duration MAX_DURATION =
+    uni_course_cpp::traversal::kMaxCost;
 constexpr uni_course_cpp::VertexId START_VERTEX_ID = 0;
-const int MAX_THREADS_COUNT = std::thread::hardware_concurrency();
+constexpr uni_course_cpp::VertexId NO_VERTEX_ID =
+    uni_course_cpp::traversal::kNoVertexId;
+constexpr uni_course_cpp::EdgeId NO_EDGE_ID =
+    uni_course_cpp::traversal::kNoEdgeId;
+constexpr int NO_LABEL_INDEX = -1;
+constexpr int BITS_PER_WORD = 64;
+constexpr int PARALLEL_CHUNK_SIZE =
+    uni_course_cpp::GraphTraverser::kParallelChunkSize;
+// Frontier shares of Beamer et al.: go bottom-up once the frontier has
+// more than 1/14 of the unexplored edges, back top-down once it has less
+// than 1/24 of the vertices
+constexpr long TOP_DOWN_EDGES_FACTOR = 14;
+constexpr long BOTTOM_UP_VERTICES_FACTOR = 24;
+
+void set_bit(std::vector<uint64_t>& bits, int index) {
+  bits[index / BITS_PER_WORD] |= uint64_t{1} << (index % BITS_PER_WORD);
+}
+
+void clear_bit(std::vector<uint64_t>& bits, int index) {
+  bits[index / BITS_PER_WORD] &= ~(uint64_t{1} << (index % BITS_PER_WORD));
+}
+
+bool test_bit(const std::vector<uint64_t>& bits, int index) {
+  return (bits[index / BITS_PER_WORD] >> (index % BITS_PER_WORD)) & 1;
+}
+
+// Sets the bit and tells whether this call is the one that set it
+bool claim_bit(std::vector<std::atomic<uint64_t>>& bits, int index) {
+  const auto mask = uint64_t{1} << (index % BITS_PER_WORD);
+  return (bits[index / BITS_PER_WORD].fetch_or(
+              mask, std::memory_order_relaxed) &
+          mask) == 0;
+}
+
+int get_chunks_count(int size) {
+  return (size + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+}
+
+// Glues `head` (source to meeting vertex) to `tail` walked from the
+// destination to the same meeting vertex
+uni_course_cpp::GraphPath join_paths(const uni_course_cpp::GraphPath& head,
+                                     const uni_course_cpp::GraphPath& tail) {
+  const auto tail_vertex_ids = tail.vertex_ids();
+  const auto tail_edge_ids = tail.edge_ids();
+  std::vector<uni_course_cpp::VertexId> vertex_ids;
+  std::vector<uni_course_cpp::EdgeId> edge_ids;
+  vertex_ids.reserve(head.vertex_ids().size() + tail_vertex_ids.size() - 1);
+  edge_ids.reserve(head.edge_ids().size() + tail_edge_ids.size());
+  vertex_ids.assign(head.vertex_ids().begin(), head.vertex_ids().end());
+  edge_ids.assign(head.edge_ids().begin(), head.edge_ids().end());
+  for (int index = tail_vertex_ids.size() - 2; index >= 0; --index) {
+    vertex_ids.push_back(tail_vertex_ids[index]);
+  }
+  for (int index = tail_edge_ids.size() - 1; index >= 0; --index) {
+    edge_ids.push_back(tail_edge_ids[index]);
+  }
+  return uni_course_cpp::GraphPath(head.duration() + tail.duration(),
+                                   std::move(vertex_ids), std::move(edge_ids));
+}
 }  // namespace
 
 namespace uni_course_cpp {
 
-GraphPath GraphTraverser::find_shortest_path(
-    const VertexId& source_vertex_id,
-    const VertexId& destination_vertex_id) const {
-  std::unordered_map<VertexId, GraphPath::Distance> distances;
-  std::unordered_map<VertexId, std::vector<VertexId>> vertex_ids;
-  std::unordered_map<VertexId, std::vector<EdgeId>> edge_ids;
-  std::unordered_map<VertexId, Edge::Duration> durations;
-  for (const auto& vertex : graph_.get_vertices()) {
-    distances[vertex.get_id()] = MAX_DISTANCE;
+void GraphTraverser::SearchScratch::reset() {
+  for (const auto vertex_id : vertex_queue) {
+    distances[vertex_id] = MAX_DISTANCE;
+    durations[vertex_id] = MAX_DURATION;
+    parent_edge_ids[vertex_id] = NO_EDGE_ID;
+    clear_bit(visited_bits, vertex_id);
+    claimed_bits[vertex_id / BITS_PER_WORD].store(0,
+                                                  std::memory_order_relaxed);
+  }
+  vertex_queue.clear();
+  for (const auto vertex_id : backward_vertex_queue) {
+    backward_distances[vertex_id] = MAX_DISTANCE;
+    backward_parent_edge_ids[vertex_id] = NO_EDGE_ID;
+  }
+  backward_vertex_queue.clear();
+  for (auto& bucket : buckets) {
+    bucket.clear();
+  }
+}
+
+GraphTraverser::ScratchLease::~ScratchLease() {
+  scratch_->reset();
+  const std::lock_guard lock(traverser_.scratch_mutex_);
+  traverser_.free_scratches_.push_back(std::move(scratch_));
+}
+
+GraphTraverser::ScratchLease GraphTraverser::acquire_scratch() const {
+  {
+    const std::lock_guard lock(scratch_mutex_);
+    if (!free_scratches_.empty()) {
+      auto scratch = std::move(free_scratches_.back());
+      free_scratches_.pop_back();
+      return ScratchLease(*this, std::move(scratch));
+    }
+  }
+  auto scratch = std::make_unique<SearchScratch>();
+  scratch->distances.assign(graph_.vertices_count(), MAX_DISTANCE);
+  scratch->durations.assign(graph_.vertices_count(), MAX_DURATION);
+  scratch->parent_edge_ids.assign(graph_.vertices_count(), NO_EDGE_ID);
+  scratch->vertex_queue.reserve(graph_.vertices_count());
+  const int words_count =
+      (graph_.vertices_count() + BITS_PER_WORD - 1) / BITS_PER_WORD;
+  scratch->visited_bits.assign(words_count, 0);
+  scratch->frontier_bits.assign(words_count, 0);
+  scratch->claimed_bits = std::vector<std::atomic<uint64_t>>(words_count);
+  for (auto& word : scratch->claimed_bits) {
+    word.store(0, std::memory_order_relaxed);
+  }
+  scratch->backward_distances.assign(graph_.vertices_count(), MAX_DISTANCE);
+  scratch->backward_parent_edge_ids.assign(graph_.vertices_count(),
+                                           NO_EDGE_ID);
+  // Priorities of queued vertices never spread by more than the longest
+  // edge, plus the shortest one for the A* lower bound, so the buckets
+  // never wrap onto each other
+  scratch->buckets.resize(2 * std::max(graph_.get_max_duration(), 1) + 1);
+  return ScratchLease(*this, std::move(scratch));
+}
+
+GraphPath GraphTraverser::build_path(const std::vector<EdgeId>& parent_edge_ids,
+                                     VertexId source_vertex_id,
+                                     VertexId destination_vertex_id) const {
+  if (destination_vertex_id != source_vertex_id &&
+      parent_edge_ids[destination_vertex_id] == NO_EDGE_ID) {
+    return GraphPath(0, {}, {});
+  }
+  int edges_count = 0;
+  for (VertexId vertex_id = destination_vertex_id;
+       vertex_id != source_vertex_id; ++edges_count) {
+    const auto& edge = graph_.get_edge(parent_edge_ids[vertex_id]);
+    vertex_id =
+        edge.get_first_vertex_id() + edge.get_second_vertex_id() - vertex_id;
+  }
+
+  std::vector<VertexId> vertex_ids(edges_count + 1);
+  std::vector<EdgeId> edge_ids(edges_count);
+  Edge::Duration duration = 0;
+  vertex_ids[edges_count] = destination_vertex_id;
+  for (int index = edges_count - 1; index >= 0; --index) {
+    const auto vertex_id = vertex_ids[index + 1];
+    const auto& edge = graph_.get_edge(parent_edge_ids[vertex_id]);
+    edge_ids[index] = edge.get_id();
+    vertex_ids[index] =
+        edge.get_first_vertex_id() + edge.get_second_vertex_id() - vertex_id;
+    duration += edge.get_duration();
+  }
+  return GraphPath(duration, std::move(vertex_ids), std::move(edge_ids));
+}
+
+void GraphTraverser::search_by_distance(
+    SearchScratch& scratch,
+    VertexId source_vertex_id,
+    VertexId destination_vertex_id) const {
+  if (breadth_first_mode_ == BreadthFirstMode::DirectionOptimizing) {
+    search_by_distance_direction_optimizing(scratch, source_vertex_id,
+                                            destination_vertex_id);
+    return;
+  }
+  if (breadth_first_mode_ == BreadthFirstMode::Parallel) {
+    search_by_distance_parallel(scratch, source_vertex_id,
+                                destination_vertex_id);
+    return;
   }
+  auto& distances = scratch.distances;
+  auto& parent_edge_ids = scratch.parent_edge_ids;
+  auto& vertex_queue = scratch.vertex_queue;
 
-  vertex_ids[source_vertex_id].push_back(source_vertex_id);
   distances[source_vertex_id] = 0;
-  std::queue<VertexId> pass_waiting;
-  pass_waiting.push(source_vertex_id);
-
-  while (!pass_waiting.empty()) {
-    const auto current_vertex_id = pass_waiting.front();
-    pass_waiting.pop();
-    for (const auto& edge_id :
-         graph_.get_connected_edges_ids(current_vertex_id)) {
-      const auto& edge = graph_.get_edge(edge_id);
-      const auto next_vertex_id = edge.get_first_vertex_id() +
-                                  edge.get_second_vertex_id() -
-                                  current_vertex_id;
-      if (distances[current_vertex_id] + 1 < distances[next_vertex_id]) {
-        pass_waiting.push(next_vertex_id);
+  vertex_queue.push_back(source_vertex_id);
+  for (int head = 0;
+       head < vertex_queue.size() &&
+       (destination_vertex_id == NO_VERTEX_ID ||
+        distances[destination_vertex_id] == MAX_DISTANCE);
+       ++head) {
+    const auto current_vertex_id = vertex_queue[head];
+    const auto connected_edge_ids =
+        graph_.get_connected_edges_ids(current_vertex_id);
+    const auto neighbor_ids = graph_.get_neighbor_ids(current_vertex_id);
+    for (int index = 0; index < connected_edge_ids.size(); ++index) {
+      const auto next_vertex_id = neighbor_ids[index];
+      if (distances[next_vertex_id] == MAX_DISTANCE) {
         distances[next_vertex_id] = distances[current_vertex_id] + 1;
-        vertex_ids[next_vertex_id] = vertex_ids[current_vertex_id];
-        edge_ids[next_vertex_id] = edge_ids[current_vertex_id];
-        durations[next_vertex_id] = durations[current_vertex_id];
+        parent_edge_ids[next_vertex_id] = connected_edge_ids[index];
+        vertex_queue.push_back(next_vertex_id);
+      }
+    }
+  }
+}
+
+void GraphTraverser::search_by_distance_direction_optimizing(
+    SearchScratch& scratch,
+    VertexId source_vertex_id,
+    VertexId destination_vertex_id) const {
+  auto& distances = scratch.distances;
+  auto& parent_edge_ids = scratch.parent_edge_ids;
+  // Levels are stored one after another, the last one being the frontier
+  auto& vertex_queue = scratch.vertex_queue;
+  auto& visited_bits = scratch.visited_bits;
+  auto& frontier_bits = scratch.frontier_bits;
+  const auto visit = [&](VertexId vertex_id, EdgeId parent_edge_id,
+                         GraphPath::Distance distance) {
+    distances[vertex_id] = distance;
+    parent_edge_ids[vertex_id] = parent_edge_id;
+    vertex_queue.push_back(vertex_id);
+    set_bit(visited_bits, vertex_id);
+  };
+
+  visit(source_vertex_id, NO_EDGE_ID, 0);
+  long unexplored_edges_count =
+      graph_.connections_count() - graph_.get_degree(source_vertex_id);
+  bool is_bottom_up = false;
+  for (int level_begin = 0, distance = 1;
+       level_begin < vertex_queue.size() &&
+       (destination_vertex_id == NO_VERTEX_ID ||
+        distances[destination_vertex_id] == MAX_DISTANCE);
+       ++distance) {
+    const int level_end = vertex_queue.size();
+    const long frontier_size = level_end - level_begin;
+    if (is_bottom_up) {
+      is_bottom_up = frontier_size * BOTTOM_UP_VERTICES_FACTOR >=
+                     graph_.vertices_count();
+    } else {
+      long frontier_edges_count = 0;
+      for (int index = level_begin; index < level_end; ++index) {
+        frontier_edges_count += graph_.get_degree(vertex_queue[index]);
+      }
+      is_bottom_up =
+          frontier_edges_count * TOP_DOWN_EDGES_FACTOR > unexplored_edges_count;
+    }
 
-        vertex_ids[next_vertex_id].push_back(next_vertex_id);
-        edge_ids[next_vertex_id].push_back(edge_id);
-        durations[next_vertex_id] += edge.get_duration();
+    if (!is_bottom_up) {
+      for (int index = level_begin; index < level_end; ++index) {
+        const auto current_vertex_id = vertex_queue[index];
+        const auto connected_edge_ids =
+            graph_.get_connected_edges_ids(current_vertex_id);
+        const auto neighbor_ids = graph_.get_neighbor_ids(current_vertex_id);
+        for (int slot = 0; slot < connected_edge_ids.size(); ++slot) {
+          const auto next_vertex_id = neighbor_ids[slot];
+          if (!test_bit(visited_bits, next_vertex_id)) {
+            visit(next_vertex_id, connected_edge_ids[slot], distance);
+            unexplored_edges_count -= graph_.get_degree(next_vertex_id);
+          }
+        }
+      }
+    } else {
+      for (int index = level_begin; index < level_end; ++index) {
+        set_bit(frontier_bits, vertex_queue[index]);
+      }
+      // Every unvisited vertex looks for any parent in the frontier; whole
+      // words of visited vertices are skipped at once
+      for (int word = 0; word < visited_bits.size(); ++word) {
+        for (auto unvisited = ~visited_bits[word]; unvisited != 0;
+             unvisited &= unvisited - 1) {
+          const VertexId vertex_id =
+              word * BITS_PER_WORD + __builtin_ctzll(unvisited);
+          if (vertex_id >= graph_.vertices_count()) {
+            break;
+          }
+          const auto connected_edge_ids =
+              graph_.get_connected_edges_ids(vertex_id);
+          const auto neighbor_ids = graph_.get_neighbor_ids(vertex_id);
+          for (int slot = 0; slot < connected_edge_ids.size(); ++slot) {
+            if (test_bit(frontier_bits, neighbor_ids[slot])) {
+              visit(vertex_id, connected_edge_ids[slot], distance);
+              unexplored_edges_count -= graph_.get_degree(vertex_id);
+              break;
+            }
+          }
+        }
+      }
+      for (int index = level_begin; index < level_end; ++index) {
+        clear_bit(frontier_bits, vertex_queue[index]);
       }
     }
+    level_begin = level_end;
   }
-  return GraphPath(durations[destination_vertex_id],
-                   std::move(vertex_ids[destination_vertex_id]),
-                   std::move(edge_ids[destination_vertex_id]));
+}
+
+void GraphTraverser::search_by_distance_parallel(
+    SearchScratch& scratch,
+    VertexId source_vertex_id,
+    VertexId destination_vertex_id) const {
+  auto& distances = scratch.distances;
+  auto& parent_edge_ids = scratch.parent_edge_ids;
+  // Levels are stored one after another, each sorted by vertex id
+  auto& vertex_queue = scratch.vertex_queue;
+  auto& claimed_bits = scratch.claimed_bits;
+  auto& chunk_frontiers = scratch.chunk_frontiers;
+  auto& thread_pool = ThreadPool::get_thread_pool();
+
+  distances[source_vertex_id] = 0;
+  vertex_queue.push_back(source_vertex_id);
+  claim_bit(claimed_bits, source_vertex_id);
+  for (int level_begin = 0, distance = 1;
+       level_begin < vertex_queue.size() &&
+       (destination_vertex_id == NO_VERTEX_ID ||
+        distances[destination_vertex_id] == MAX_DISTANCE);
+       ++distance) {
+    const int level_end = vertex_queue.size();
+    const int chunks_count = get_chunks_count(level_end - level_begin);
+    if (chunk_frontiers.size() < chunks_count) {
+      chunk_frontiers.resize(chunks_count);
+    }
+    thread_pool.parallel_for(
+        0, chunks_count,
+        [level_begin, level_end, &vertex_queue, &claimed_bits,
+         &chunk_frontiers, this](int chunk) {
+          auto& next_frontier = chunk_frontiers[chunk];
+          const int chunk_end =
+              std::min(level_begin + (chunk + 1) * PARALLEL_CHUNK_SIZE,
+                       level_end);
+          for (int index = level_begin + chunk * PARALLEL_CHUNK_SIZE;
+               index < chunk_end; ++index) {
+            for (const auto next_vertex_id :
+                 graph_.get_neighbor_ids(vertex_queue[index])) {
+              if (claim_bit(claimed_bits, next_vertex_id)) {
+                next_frontier.push_back(next_vertex_id);
+              }
+            }
+          }
+        });
+    for (int chunk = 0; chunk < chunks_count; ++chunk) {
+      vertex_queue.insert(vertex_queue.end(), chunk_frontiers[chunk].begin(),
+                          chunk_frontiers[chunk].end());
+      chunk_frontiers[chunk].clear();
+    }
+    std::sort(vertex_queue.begin() + level_end, vertex_queue.end());
+
+    const int next_level_end = vertex_queue.size();
+    thread_pool.parallel_for(
+        0, get_chunks_count(next_level_end - level_end),
+        [level_end, next_level_end, distance, &distances, &parent_edge_ids,
+         &vertex_queue, this](int chunk) {
+          const int chunk_end = std::min(
+              level_end + (chunk + 1) * PARALLEL_CHUNK_SIZE, next_level_end);
+          for (int index = level_end + chunk * PARALLEL_CHUNK_SIZE;
+               index < chunk_end; ++index) {
+            const auto vertex_id = vertex_queue[index];
+            const auto connected_edge_ids =
+                graph_.get_connected_edges_ids(vertex_id);
+            const auto neighbor_ids = graph_.get_neighbor_ids(vertex_id);
+            auto parent_edge_id = NO_EDGE_ID;
+            for (int slot = 0; slot < connected_edge_ids.size(); ++slot) {
+              if (distances[neighbor_ids[slot]] == distance - 1 &&
+                  (parent_edge_id == NO_EDGE_ID ||
+                   connected_edge_ids[slot] < parent_edge_id)) {
+                parent_edge_id = connected_edge_ids[slot];
+              }
+            }
+            parent_edge_ids[vertex_id] = parent_edge_id;
+          }
+        });
+    for (int index = level_end; index < next_level_end; ++index) {
+      distances[vertex_queue[index]] = distance;
+    }
+    level_begin = level_end;
+  }
+}
+
+int GraphTraverser::get_edges_count_bound(VertexId first_vertex_id,
+                                          VertexId second_vertex_id) const {
+  const auto max_depth_gap = graph_.get_max_depth_gap();
+  if (max_depth_gap == 0) {
+    return 0;
+  }
+  const auto depth_gap = std::abs(graph_.get_vertex_depth(first_vertex_id) -
+                                  graph_.get_vertex_depth(second_vertex_id));
+  return (depth_gap + max_depth_gap - 1) / max_depth_gap;
+}
+
+VertexId GraphTraverser::search_bidirectional(
+    SearchScratch& scratch,
+    VertexId source_vertex_id,
+    VertexId destination_vertex_id) const {
+  if (source_vertex_id == destination_vertex_id) {
+    return source_vertex_id;
+  }
+  scratch.distances[source_vertex_id] = 0;
+  scratch.vertex_queue.push_back(source_vertex_id);
+  scratch.backward_distances[destination_vertex_id] = 0;
+  scratch.backward_vertex_queue.push_back(destination_vertex_id);
+
+  VertexId meeting_vertex_id = NO_VERTEX_ID;
+  GraphPath::Distance meeting_distance = MAX_DISTANCE;
+  // Expands every vertex of the frontier, noting the shortest path through
+  // any vertex already reached from the other side. The first level that
+  // meets the other side contains a shortest path.
+  const auto expand_level =
+      [&meeting_vertex_id, &meeting_distance, this](
+          std::vector<GraphPath::Distance>& distances,
+          std::vector<EdgeId>& parent_edge_ids,
+          std::vector<VertexId>& vertex_queue, int& head,
+          const std::vector<GraphPath::Distance>& other_distances) {
+        for (const int level_end = vertex_queue.size(); head < level_end;
+             ++head) {
+          const auto current_vertex_id = vertex_queue[head];
+          const auto connected_edge_ids =
+              graph_.get_connected_edges_ids(current_vertex_id);
+          const auto neighbor_ids = graph_.get_neighbor_ids(current_vertex_id);
+          for (int index = 0; index < connected_edge_ids.size(); ++index) {
+            const auto next_vertex_id = neighbor_ids[index];
+            if (distances[next_vertex_id] == MAX_DISTANCE) {
+              distances[next_vertex_id] = distances[current_vertex_id] + 1;
+              parent_edge_ids[next_vertex_id] = connected_edge_ids[index];
+              vertex_queue.push_back(next_vertex_id);
+            }
+            if (other_distances[next_vertex_id] != MAX_DISTANCE &&
+                distances[next_vertex_id] + other_distances[next_vertex_id] <
+                    meeting_distance) {
+              meeting_distance =
+                  distances[next_vertex_id] + other_distances[next_vertex_id];
+              meeting_vertex_id = next_vertex_id;
+            }
+          }
+        }
+      };
+
+  int forward_head = 0;
+  int backward_head = 0;
+  while (meeting_vertex_id == NO_VERTEX_ID &&
+         forward_head < scratch.vertex_queue.size() &&
+         backward_head < scratch.backward_vertex_queue.size()) {
+    if (scratch.vertex_queue.size() - forward_head <=
+        scratch.backward_vertex_queue.size() - backward_head) {
+      expand_level(scratch.distances, scratch.parent_edge_ids,
+                   scratch.vertex_queue, forward_head,
+                   scratch.backward_distances);
+    } else {
+      expand_level(scratch.backward_distances,
+                   scratch.backward_parent_edge_ids,
+                   scratch.backward_vertex_queue, backward_head,
+                   scratch.distances);
+    }
+  }
+  return meeting_vertex_id;
+}
+
+std::vector<GraphPath> GraphTraverser::build_paths(
+    const std::vector<EdgeId>& parent_edge_ids,
+    VertexId source_vertex_id,
+    ArrayView<VertexId> destination_vertex_ids) const {
+  std::vector<GraphPath> paths(destination_vertex_ids.size(),
+                               GraphPath(0, {}, {}));
+  ThreadPool::get_thread_pool().parallel_for(
+      0, destination_vertex_ids.size(),
+      [&parent_edge_ids, source_vertex_id, &destination_vertex_ids, &paths,
+       this](int index) {
+        paths[index] = build_path(parent_edge_ids, source_vertex_id,
+                                  destination_vertex_ids[index]);
+      });
+  return paths;
+}
+
+GraphPath GraphTraverser::find_shortest_path(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id) const {
+  return find_path(source_vertex_id, destination_vertex_id,
+                   traversal::HopWeight());
 }
 
 GraphPath GraphTraverser::find_fastest_path(
     const VertexId& source_vertex_id,
     const VertexId& destination_vertex_id) const {
-  std::unordered_map<VertexId, std::vector<VertexId>> vertex_ids;
-  std::unordered_map<VertexId, std::vector<EdgeId>> edge_ids;
-  std::unordered_map<VertexId, Edge::Duration> path_durations;
-  std::unordered_map<VertexId, Edge::Duration> durations;
-  for (const auto& vertex : graph_.get_vertices()) {
-    durations[vertex.get_id()] = MAX_DURATION;
-  }
-  durations[source_vertex_id] = 0;
-
-  vertex_ids[source_vertex_id].push_back(source_vertex_id);
-  std::queue<VertexId> pass_waiting;
-  pass_waiting.push(source_vertex_id);
-
-  while (!pass_waiting.empty()) {
-    const auto current_vertex_id = pass_waiting.front();
-    pass_waiting.pop();
-    for (const auto& edge_id :
-         graph_.get_connected_edges_ids(current_vertex_id)) {
-      const auto& edge = graph_.get_edge(edge_id);
-      const auto next_vertex_id = edge.get_first_vertex_id() +
-                                  edge.get_second_vertex_id() -
-                                  current_vertex_id;
-      if (durations[current_vertex_id] + edge.get_duration() <
-          durations[next_vertex_id]) {
-        pass_waiting.push(next_vertex_id);
-        durations[next_vertex_id] =
-            durations[current_vertex_id] + edge.get_duration();
-        vertex_ids[next_vertex_id] = vertex_ids[current_vertex_id];
-        edge_ids[next_vertex_id] = edge_ids[current_vertex_id];
-        path_durations[next_vertex_id] = path_durations[current_vertex_id];
-
-        vertex_ids[next_vertex_id].push_back(next_vertex_id);
-        edge_ids[next_vertex_id].push_back(edge_id);
-        path_durations[next_vertex_id] += edge.get_duration();
-      }
-    }
+  return find_path(source_vertex_id, destination_vertex_id,
+                   traversal::DurationWeight());
+}
+
+GraphPath GraphTraverser::find_shortest_path(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id,
+    FrozenGraph::ColorMask allowed_colors) const {
+  return find_path(
+      source_vertex_id, destination_vertex_id,
+      traversal::ColorFilteredWeight<traversal::HopWeight>(allowed_colors));
+}
+
+GraphPath GraphTraverser::find_fastest_path(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id,
+    FrozenGraph::ColorMask allowed_colors) const {
+  return find_path(
+      source_vertex_id, destination_vertex_id,
+      traversal::ColorFilteredWeight<traversal::DurationWeight>(
+          allowed_colors));
+}
+
+GraphPath GraphTraverser::find_guided_shortest_path(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id) const {
+  const auto scratch = acquire_scratch();
+  const auto meeting_vertex_id =
+      search_bidirectional(*scratch, source_vertex_id, destination_vertex_id);
+  if (meeting_vertex_id == NO_VERTEX_ID) {
+    return GraphPath(0, {}, {});
   }
-  return GraphPath(durations[destination_vertex_id],
-                   std::move(vertex_ids[destination_vertex_id]),
-                   std::move(edge_ids[destination_vertex_id]));
+  return join_paths(
+      build_path(scratch->parent_edge_ids, source_vertex_id,
+                 meeting_vertex_id),
+      build_path(scratch->backward_parent_edge_ids, destination_vertex_id,
+                 meeting_vertex_id));
 }
 
-std::vector<GraphPath> GraphTraverser::find_all_paths() const {
-  std::vector<GraphPath> paths;
-  using JobCallback = std::function<void()>;
-  auto jobs = std::list<JobCallback>();
-  std::mutex mutex;
-  std::atomic<int> finished_paths = 0;
-  std::atomic<bool> should_terminate = false;
-  std::vector<VertexId> finish_vertex_ids =
-      graph_.get_vertex_ids_at_depth(graph_.get_depth() - 1);
-  for (const auto& end_vertex_id : finish_vertex_ids) {
-    jobs.push_back([end_vertex_id, &paths, &mutex, &finished_paths, this]() {
-      const GraphPath new_path =
-          find_shortest_path(START_VERTEX_ID, end_vertex_id);
-      {
-        const std::lock_guard lock(mutex);
-        paths.push_back(std::move(new_path));
+GraphPath GraphTraverser::find_guided_fastest_path(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id) const {
+  const auto scratch = acquire_scratch();
+  const auto min_duration = graph_.get_min_duration();
+  search_by_weight(
+      *scratch, scratch->durations, source_vertex_id, destination_vertex_id,
+      traversal::DurationWeight(),
+      [destination_vertex_id, min_duration, this](VertexId vertex_id) {
+        return get_edges_count_bound(vertex_id, destination_vertex_id) *
+               min_duration;
+      });
+  return build_path(scratch->parent_edge_ids, source_vertex_id,
+                    destination_vertex_id);
+}
+
+GraphTraverser::BicriteriaPaths GraphTraverser::find_bicriteria_paths(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id,
+    bool with_pareto_paths) const {
+  assert(graph_.edges_count() == 0 || graph_.get_min_duration() > 0);
+  // A path prefix; only labels better than every earlier one at their
+  // vertex are kept, so each is Pareto-optimal when popped
+  struct Label {
+    VertexId vertex_id = 0;
+    Edge::Duration duration = 0;
+    GraphPath::Distance distance = 0;
+    int parent_label_index = NO_LABEL_INDEX;
+    EdgeId edge_id = NO_EDGE_ID;
+  };
+  const auto scratch = acquire_scratch();
+  // Fewest edges among the labels settled at each vertex so far
+  auto& best_distances = scratch->distances;
+  auto& buckets = scratch->buckets;
+  auto& reached_vertex_ids = scratch->vertex_queue;
+  std::vector<Label> labels;
+  std::vector<int> destination_label_indices;
+  const auto build_label_path = [&labels](int label_index) {
+    std::vector<VertexId> vertex_ids;
+    std::vector<EdgeId> edge_ids;
+    const auto duration = labels[label_index].duration;
+    for (; label_index != NO_LABEL_INDEX;
+         label_index = labels[label_index].parent_label_index) {
+      vertex_ids.push_back(labels[label_index].vertex_id);
+      if (labels[label_index].edge_id != NO_EDGE_ID) {
+        edge_ids.push_back(labels[label_index].edge_id);
+      }
+    }
+    std::reverse(vertex_ids.begin(), vertex_ids.end());
+    std::reverse(edge_ids.begin(), edge_ids.end());
+    return GraphPath(duration, std::move(vertex_ids), std::move(edge_ids));
+  };
+
+  // Fewest edges from each vertex to the destination, from a plain
+  // breadth-first pass over the same adjacency
+  auto& remaining_distances = scratch->backward_distances;
+  auto& backward_vertex_queue = scratch->backward_vertex_queue;
+  remaining_distances[destination_vertex_id] = 0;
+  backward_vertex_queue.push_back(destination_vertex_id);
+  for (int head = 0; head < backward_vertex_queue.size(); ++head) {
+    const auto vertex_id = backward_vertex_queue[head];
+    for (const auto next_vertex_id : graph_.get_neighbor_ids(vertex_id)) {
+      if (remaining_distances[next_vertex_id] == MAX_DISTANCE) {
+        remaining_distances[next_vertex_id] =
+            remaining_distances[vertex_id] + 1;
+        backward_vertex_queue.push_back(next_vertex_id);
       }
-      finished_paths++;
-    });
+    }
   }
-  const auto worker = [&should_terminate, &mutex, &jobs]() {
-    while (true) {
-      if (should_terminate) {
-        return;
+  // Otherwise every vertex the sweep reaches has a finite entry
+  if (remaining_distances[source_vertex_id] == MAX_DISTANCE) {
+    return {GraphPath(0, {}, {}), GraphPath(0, {}, {}), {}};
+  }
+
+  // Buckets are keyed by duration plus a bound of the rest of the way,
+  // which at a given vertex is still duration order
+  const auto min_duration = graph_.get_min_duration();
+  const auto get_estimate = [&labels, &remaining_distances,
+                             min_duration](int label_index) {
+    const auto& label = labels[label_index];
+    return label.duration + remaining_distances[label.vertex_id] * min_duration;
+  };
+  const auto min_distance = remaining_distances[source_vertex_id];
+
+  labels.push_back({source_vertex_id, 0, 0, NO_LABEL_INDEX, NO_EDGE_ID});
+  buckets[get_estimate(0) % buckets.size()].push_back(0);
+  int queued_count = 1;
+  // Estimates never decrease along a path. Each bucket is drained as a
+  // heap by distance, which also orders the labels an expansion adds to
+  // it, so the first label settled at the destination is the
+  // (duration, distance) optimum and the last one the (distance, duration)
+  // optimum.
+  const auto is_farther = [&labels](int first_index, int second_index) {
+    return std::make_pair(labels[first_index].distance, first_index) >
+           std::make_pair(labels[second_index].distance, second_index);
+  };
+  for (int estimate = get_estimate(0);
+       queued_count > 0 && best_distances[destination_vertex_id] > min_distance;
+       ++estimate) {
+    auto& bucket = buckets[estimate % buckets.size()];
+    std::make_heap(bucket.begin(), bucket.end(), is_farther);
+    while (!bucket.empty()) {
+      std::pop_heap(bucket.begin(), bucket.end(), is_farther);
+      const auto label_index = bucket.back();
+      bucket.pop_back();
+      --queued_count;
+      const auto label = labels[label_index];
+      // Neither this label nor any extension of it can beat the fewest
+      // edges the destination already has at a lower duration
+      if (label.distance >= best_distances[label.vertex_id] ||
+          label.distance + remaining_distances[label.vertex_id] >=
+              best_distances[destination_vertex_id]) {
+        continue;
+      }
+      if (best_distances[label.vertex_id] == MAX_DISTANCE) {
+        reached_vertex_ids.push_back(label.vertex_id);
+      }
+      best_distances[label.vertex_id] = label.distance;
+      if (label.vertex_id == destination_vertex_id) {
+        destination_label_indices.push_back(label_index);
+        continue;
       }
-      const auto job_optional = [&jobs,
-                                 &mutex]() -> std::optional<JobCallback> {
-        const std::lock_guard lock(mutex);
-        if (!jobs.empty()) {
-          const auto job = jobs.front();
-          jobs.pop_front();
-          return job;
+      const auto connected_edge_ids =
+          graph_.get_connected_edges_ids(label.vertex_id);
+      const auto neighbor_ids = graph_.get_neighbor_ids(label.vertex_id);
+      for (int index = 0; index < connected_edge_ids.size(); ++index) {
+        const auto next_vertex_id = neighbor_ids[index];
+        if (label.distance + 1 >= best_distances[next_vertex_id] ||
+            label.distance + 1 + remaining_distances[next_vertex_id] >=
+                best_distances[destination_vertex_id]) {
+          continue;
         }
-        return std::nullopt;
-      }();
-      if (job_optional.has_value()) {
-        const auto& job = job_optional.value();
-        job();
+        const auto& edge = graph_.get_edge(connected_edge_ids[index]);
+        labels.push_back({next_vertex_id, label.duration + edge.get_duration(),
+                          label.distance + 1, label_index, edge.get_id()});
+        const int next_label_index = labels.size() - 1;
+        const auto next_estimate = get_estimate(next_label_index);
+        auto& next_bucket = buckets[next_estimate % buckets.size()];
+        next_bucket.push_back(next_label_index);
+        if (next_estimate == estimate) {
+          std::push_heap(next_bucket.begin(), next_bucket.end(), is_farther);
+        }
+        ++queued_count;
       }
     }
-  };
-
-  const auto threads_num = std::min(
-      MAX_THREADS_COUNT,
-      static_cast<int>(
-          graph_.get_vertex_ids_at_depth(graph_.get_depth() - 1).size()));
-  auto threads = std::vector<std::thread>();
-  threads.reserve(threads_num);
-
-  for (int i = 0; i < threads_num; i++) {
-    threads.push_back(std::thread(worker));
   }
 
-  while (finished_paths < finish_vertex_ids.size()) {
+  if (destination_label_indices.empty()) {
+    return {GraphPath(0, {}, {}), GraphPath(0, {}, {}), {}};
   }
-
-  should_terminate = true;
-  for (auto& thread : threads) {
-    thread.join();
+  BicriteriaPaths paths = {build_label_path(destination_label_indices.back()),
+                           build_label_path(destination_label_indices.front()),
+                           {}};
+  if (with_pareto_paths) {
+    for (const auto label_index : destination_label_indices) {
+      paths.pareto_paths.push_back(build_label_path(label_index));
+    }
   }
   return paths;
 }
+
+GraphPath GraphTraverser::find_shortest_path(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id,
+    const LandmarkIndex& landmark_index) const {
+  check_landmark_index(landmark_index);
+  const auto scratch = acquire_scratch();
+  search_by_weight(
+      *scratch, scratch->distances, source_vertex_id, destination_vertex_id,
+      traversal::HopWeight(),
+      [destination_vertex_id, &landmark_index](VertexId vertex_id) {
+        return landmark_index.get_distance_bound(vertex_id,
+                                                 destination_vertex_id);
+      });
+  return build_path(scratch->parent_edge_ids, source_vertex_id,
+                    destination_vertex_id);
+}
+
+GraphPath GraphTraverser::find_fastest_path(
+    const VertexId& source_vertex_id,
+    const VertexId& destination_vertex_id,
+    const LandmarkIndex& landmark_index) const {
+  check_landmark_index(landmark_index);
+  const auto scratch = acquire_scratch();
+  search_by_weight(
+      *scratch, scratch->durations, source_vertex_id, destination_vertex_id,
+      traversal::DurationWeight(),
+      [destination_vertex_id, &landmark_index](VertexId vertex_id) {
+        return landmark_index.get_duration_bound(vertex_id,
+                                                 destination_vertex_id);
+      });
+  return build_path(scratch->parent_edge_ids, source_vertex_id,
+                    destination_vertex_id);
+}
+
+void GraphTraverser::check_landmark_index(
+    const LandmarkIndex& landmark_index) const {
+  if (landmark_index.vertices_count() != graph_.vertices_count()) {
+    throw std::runtime_error("Landmark index belongs to another graph!\n");
+  }
+}
+
+std::vector<GraphPath::Distance> GraphTraverser::find_distances(
+    const VertexId& source_vertex_id) const {
+  const auto scratch = acquire_scratch();
+  search_by_distance(*scratch, source_vertex_id, NO_VERTEX_ID);
+  return scratch->distances;
+}
+
+std::vector<Edge::Duration> GraphTraverser::find_durations(
+    const VertexId& source_vertex_id) const {
+  const auto scratch = acquire_scratch();
+  search_by_weight(*scratch, scratch->durations, source_vertex_id,
+                   NO_VERTEX_ID, traversal::DurationWeight(),
+                   traversal::NoLowerBound());
+  return scratch->durations;
+}
+
+std::vector<GraphPath> GraphTraverser::find_all_paths() const {
+  const auto scratch = acquire_scratch();
+  search(*scratch, START_VERTEX_ID, NO_VERTEX_ID, traversal::HopWeight());
+  return build_paths(scratch->parent_edge_ids, START_VERTEX_ID,
+                     graph_.get_vertex_ids_at_depth(graph_.get_depth() - 1));
+}
+
+std::vector<CompactGraphPath> GraphTraverser::find_all_compact_paths() const {
+  const auto tree = find_shortest_path_tree();
+  return std::vector<CompactGraphPath>(tree.begin(), tree.end());
+}
+
+ShortestPathTree GraphTraverser::find_shortest_path_tree() const {
+  const auto scratch = acquire_scratch();
+  search(*scratch, START_VERTEX_ID, NO_VERTEX_ID, traversal::HopWeight());
+  return ShortestPathTree(
+      std::make_shared<const PredecessorTree>(
+          graph_.get_edges(), START_VERTEX_ID, scratch->parent_edge_ids),
+      graph_.get_vertex_ids_at_depth(graph_.get_depth() - 1).to_vector());
+}
+
+std::vector<GraphPath> GraphTraverser::find_all_fastest_paths() const {
+  const auto scratch = acquire_scratch();
+  search(*scratch, START_VERTEX_ID, NO_VERTEX_ID,
+         traversal::DurationWeight());
+  return build_paths(scratch->parent_edge_ids, START_VERTEX_ID,
+                     graph_.get_vertex_ids_at_depth(graph_.get_depth() - 1));
+}
 }  // namespace uni_course_cpp
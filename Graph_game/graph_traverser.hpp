@@ -1,21 +1,296 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "array_view.hpp"
+#include "frozen_graph.hpp"
 #include "graph.hpp"
 #include "graph_path.hpp"
+#include "landmark_index.hpp"
+#include "multi_source_paths.hpp"
+#include "predecessor_tree.hpp"
+#include "shortest_path_tree.hpp"
+#include "traversal_core.hpp"
 
 namespace uni_course_cpp {
 class GraphTraverser {
  public:
-  GraphTraverser(const Graph& graph) : graph_(graph) {}
+  // Vertices per task of the parallel level sweeps
+  static constexpr int kParallelChunkSize = 1024;
+
+  // How breadth-first searches by distance expand their frontier
+  enum class BreadthFirstMode {
+    Queue,
+    // Switches to scanning unvisited vertices against a frontier bitset
+    // while the frontier holds a large part of the remaining edges
+    DirectionOptimizing,
+    // Expands each level on every thread of the pool. The tree does not
+    // depend on scheduling: the parent of a vertex is its smallest edge id
+    // into the previous level
+    Parallel,
+  };
+
+  // Which edges `find_shortest_path`, `find_fastest_path` and the
+  // `find_all_*` queries may follow; the other queries are undirected
+  enum class Direction {
+    Undirected,
+    // Only edges to strictly deeper vertices, swept level by level in
+    // depth order with one pull per vertex and each level in parallel.
+    // Ties go to the smallest edge id.
+    ForwardOnly,
+  };
+
+  // Freezes a private snapshot of `graph`; prefer the `FrozenGraph`
+  // overload when several traversers share the same map.
+  GraphTraverser(const Graph& graph,
+                 BreadthFirstMode breadth_first_mode = BreadthFirstMode::Queue,
+                 Direction direction = Direction::Undirected)
+      : owned_graph_(std::make_unique<FrozenGraph>(graph)),
+        graph_(*owned_graph_),
+        breadth_first_mode_(breadth_first_mode),
+        direction_(direction) {}
+  GraphTraverser(const FrozenGraph& graph,
+                 BreadthFirstMode breadth_first_mode = BreadthFirstMode::Queue,
+                 Direction direction = Direction::Undirected)
+      : graph_(graph),
+        breadth_first_mode_(breadth_first_mode),
+        direction_(direction) {}
 
   GraphPath find_shortest_path(const VertexId& source_vertex_id,
                                const VertexId& destination_vertex_id) const;
   GraphPath find_fastest_path(const VertexId& source_vertex_id,
                               const VertexId& destination_vertex_id) const;
+  // Restricted to edges whose color is in `allowed_colors`, e.g.
+  // `kAllColors & ~make_color_mask({Edge::Color::Red})` to avoid red ones
+  GraphPath find_shortest_path(const VertexId& source_vertex_id,
+                               const VertexId& destination_vertex_id,
+                               FrozenGraph::ColorMask allowed_colors) const;
+  GraphPath find_fastest_path(const VertexId& source_vertex_id,
+                              const VertexId& destination_vertex_id,
+                              FrozenGraph::ColorMask allowed_colors) const;
+  // Cheapest path under any weight policy of `traversal_core.hpp`, searched
+  // with the queue the policy asks for and compiled for it, so the weight is
+  // inlined into the inner loop. `find_shortest_path` and
+  // `find_fastest_path` are the `HopWeight` and `DurationWeight` cases.
+  template <typename Weight>
+  GraphPath find_path(const VertexId& source_vertex_id,
+                      const VertexId& destination_vertex_id,
+                      const Weight& weight) const {
+    const auto scratch = acquire_scratch();
+    search(*scratch, source_vertex_id, destination_vertex_id, weight);
+    return build_path(scratch->parent_edge_ids, source_vertex_id,
+                      destination_vertex_id);
+  }
+  // Same optimal paths for point-to-point queries, settling only a small
+  // part of large maps: the shortest one meets in the middle of two
+  // breadth-first searches, the fastest one runs A* with a depth bound,
+  // as every edge changes depth by at most `get_max_depth_gap()`
+  GraphPath find_guided_shortest_path(
+      const VertexId& source_vertex_id,
+      const VertexId& destination_vertex_id) const;
+  GraphPath find_guided_fastest_path(
+      const VertexId& source_vertex_id,
+      const VertexId& destination_vertex_id) const;
+
+  struct BicriteriaPaths {
+    // Fewest edges, then least duration
+    GraphPath shortest_path;
+    // Least duration, then fewest edges
+    GraphPath fastest_path;
+    // Every Pareto-optimal trade-off from `fastest_path` to
+    // `shortest_path`, by increasing duration; filled on request only
+    std::vector<GraphPath> pareto_paths;
+  };
+  // Both optima from one label-setting sweep in duration order; ties are
+  // broken the same way on every run
+  BicriteriaPaths find_bicriteria_paths(const VertexId& source_vertex_id,
+                                        const VertexId& destination_vertex_id,
+                                        bool with_pareto_paths = false) const;
+
+  // Exact A* with the landmark bounds of `landmark_index`, which must have
+  // been built for this graph
+  GraphPath find_shortest_path(const VertexId& source_vertex_id,
+                               const VertexId& destination_vertex_id,
+                               const LandmarkIndex& landmark_index) const;
+  GraphPath find_fastest_path(const VertexId& source_vertex_id,
+                              const VertexId& destination_vertex_id,
+                              const LandmarkIndex& landmark_index) const;
+
+  // Costs from the source to every vertex, `INT_MAX` when unreachable
+  std::vector<GraphPath::Distance> find_distances(
+      const VertexId& source_vertex_id) const;
+  std::vector<Edge::Duration> find_durations(
+      const VertexId& source_vertex_id) const;
 
+  // Paths from vertex 0 to every vertex at the last depth, ordered like
+  // `get_vertex_ids_at_depth`. One search serves all targets.
   std::vector<GraphPath> find_all_paths() const;
+  std::vector<GraphPath> find_all_fastest_paths() const;
+  // Same targets as `find_all_paths`, all sharing one predecessor tree
+  std::vector<CompactGraphPath> find_all_compact_paths() const;
+  // The tree behind `find_all_compact_paths`, with the targets in the same
+  // order; memory stays linear in the vertices count
+  ShortestPathTree find_shortest_path_tree() const;
+
+  // Shortest paths between many sources and destinations at once, with
+  // one bit-parallel search per `MultiSourcePaths::kBatchSize` sources.
+  // The result refers to this traverser's graph.
+  MultiSourcePaths find_multi_source_paths(
+      ArrayView<VertexId> source_vertex_ids,
+      ArrayView<VertexId> destination_vertex_ids) const {
+    return MultiSourcePaths(graph_, source_vertex_ids, destination_vertex_ids);
+  }
 
  private:
-  const Graph& graph_;
+  // Working memory of one query, sized for `graph_`. Between queries every
+  // distance is unreached, so a query only resets the entries it touched.
+  struct SearchScratch {
+    // Restores the entries of every vertex listed in the vertex queues
+    void reset();
+
+    std::vector<GraphPath::Distance> distances;
+    std::vector<Edge::Duration> durations;
+    std::vector<EdgeId> parent_edge_ids;
+    std::vector<VertexId> vertex_queue;
+    // One bit per vertex, all clear between queries
+    std::vector<uint64_t> visited_bits;
+    std::vector<uint64_t> frontier_bits;
+    // Set by whichever thread of a parallel search first reaches a vertex
+    std::vector<std::atomic<uint64_t>> claimed_bits;
+    std::vector<std::vector<VertexId>> chunk_frontiers;
+    // Search from the destination of `find_guided_shortest_path`
+    std::vector<GraphPath::Distance> backward_distances;
+    std::vector<EdgeId> backward_parent_edge_ids;
+    std::vector<VertexId> backward_vertex_queue;
+    // Storage of the queues of `search_by_weight`
+    std::vector<std::vector<VertexId>> buckets;
+    std::vector<std::pair<int, VertexId>> keyed_vertex_queue;
+  };
+
+  // Borrows a scratch from the traverser and gives it back, reset, when
+  // destroyed, so repeated and concurrent queries allocate nothing in
+  // steady state
+  class ScratchLease {
+   public:
+    ScratchLease(const GraphTraverser& traverser,
+                 std::unique_ptr<SearchScratch> scratch)
+        : traverser_(traverser), scratch_(std::move(scratch)) {}
+    ~ScratchLease();
+
+    SearchScratch& operator*() const { return *scratch_; }
+    SearchScratch* operator->() const { return scratch_.get(); }
+
+   private:
+    const GraphTraverser& traverser_;
+    std::unique_ptr<SearchScratch> scratch_;
+  };
+
+  ScratchLease acquire_scratch() const;
+  // Single-source searches filling `scratch` until `destination_vertex_id`
+  // is settled, or the whole reachable graph for `NO_VERTEX_ID`. Every
+  // reached vertex is appended to `scratch.vertex_queue` exactly once.
+  void search_by_distance(SearchScratch& scratch,
+                          VertexId source_vertex_id,
+                          VertexId destination_vertex_id) const;
+  void search_by_distance_direction_optimizing(
+      SearchScratch& scratch,
+      VertexId source_vertex_id,
+      VertexId destination_vertex_id) const;
+  void search_by_distance_parallel(SearchScratch& scratch,
+                                   VertexId source_vertex_id,
+                                   VertexId destination_vertex_id) const;
+  // `traversal::search` over `costs`, the scratch array of the metric, with
+  // the queue of `Weight`. A lower bound breaks the FIFO order of equal
+  // weights, so those get buckets instead.
+  template <typename Weight, typename LowerBound>
+  void search_by_weight(SearchScratch& scratch,
+                        std::vector<int>& costs,
+                        VertexId source_vertex_id,
+                        VertexId destination_vertex_id,
+                        const Weight& weight,
+                        const LowerBound& lower_bound) const;
+  // Search of the queries that follow `direction_`, by breadth-first search
+  // in `breadth_first_mode_` for plain hops; returns the costs it filled
+  template <typename Weight>
+  std::vector<int>& search(SearchScratch& scratch,
+                           VertexId source_vertex_id,
+                           VertexId destination_vertex_id,
+                           const Weight& weight) const;
+  // Returns a vertex on a shortest path, `NO_VERTEX_ID` if unreachable
+  VertexId search_bidirectional(SearchScratch& scratch,
+                                VertexId source_vertex_id,
+                                VertexId destination_vertex_id) const;
+  void check_landmark_index(const LandmarkIndex& landmark_index) const;
+  // Lower bound on the number of edges of any path between the vertices
+  int get_edges_count_bound(VertexId first_vertex_id,
+                            VertexId second_vertex_id) const;
+  // Follows `parent_edge_ids` back from `destination_vertex_id`
+  GraphPath build_path(const std::vector<EdgeId>& parent_edge_ids,
+                       VertexId source_vertex_id,
+                       VertexId destination_vertex_id) const;
+  // `build_path` for every destination, extracted in parallel
+  std::vector<GraphPath> build_paths(
+      const std::vector<EdgeId>& parent_edge_ids,
+      VertexId source_vertex_id,
+      ArrayView<VertexId> destination_vertex_ids) const;
+
+  std::unique_ptr<const FrozenGraph> owned_graph_;
+  const FrozenGraph& graph_;
+  BreadthFirstMode breadth_first_mode_ = BreadthFirstMode::Queue;
+  Direction direction_ = Direction::Undirected;
+  mutable std::mutex scratch_mutex_;
+  mutable std::vector<std::unique_ptr<SearchScratch>> free_scratches_;
 };
+
+template <typename Weight, typename LowerBound>
+void GraphTraverser::search_by_weight(SearchScratch& scratch,
+                                      std::vector<int>& costs,
+                                      VertexId source_vertex_id,
+                                      VertexId destination_vertex_id,
+                                      const Weight& weight,
+                                      const LowerBound& lower_bound) const {
+  constexpr bool kIsBounded =
+      !std::is_same_v<LowerBound, traversal::NoLowerBound>;
+  const traversal::SearchState state{costs, scratch.parent_edge_ids,
+                                     scratch.vertex_queue};
+  if constexpr (Weight::kQueuePolicy == traversal::QueuePolicy::Fifo &&
+                !kIsBounded) {
+    traversal::FifoQueue queue(scratch.keyed_vertex_queue);
+    traversal::search(graph_, state, queue, source_vertex_id,
+                      destination_vertex_id, weight, lower_bound);
+  } else if constexpr (Weight::kQueuePolicy != traversal::QueuePolicy::Heap) {
+    traversal::BucketQueue queue(scratch.buckets);
+    traversal::search(graph_, state, queue, source_vertex_id,
+                      destination_vertex_id, weight, lower_bound);
+  } else {
+    traversal::HeapQueue queue(scratch.keyed_vertex_queue);
+    traversal::search(graph_, state, queue, source_vertex_id,
+                      destination_vertex_id, weight, lower_bound);
+  }
+}
+
+template <typename Weight>
+std::vector<int>& GraphTraverser::search(SearchScratch& scratch,
+                                         VertexId source_vertex_id,
+                                         VertexId destination_vertex_id,
+                                         const Weight& weight) const {
+  constexpr bool kIsHops = std::is_same_v<Weight, traversal::HopWeight>;
+  auto& costs = kIsHops ? scratch.distances : scratch.durations;
+  if (direction_ == Direction::ForwardOnly) {
+    traversal::search_forward(
+        graph_, {costs, scratch.parent_edge_ids, scratch.vertex_queue},
+        source_vertex_id, destination_vertex_id, weight, kParallelChunkSize);
+  } else if constexpr (kIsHops) {
+    search_by_distance(scratch, source_vertex_id, destination_vertex_id);
+  } else {
+    search_by_weight(scratch, costs, source_vertex_id, destination_vertex_id,
+                     weight, traversal::NoLowerBound());
+  }
+  return costs;
+}
 }  // namespace uni_course_cpp
@@ -0,0 +1,159 @@
+#include "json_writer.hpp"
+#include <array>
+#include <stdexcept>
+#include <utility>
+#include "graph_printing.hpp"
+
+namespace uni_course_cpp {
+namespace printing {
+namespace json {
+
+namespace {
+constexpr int MAX_INT_DIGITS = 11;
+
+std::string_view color_name(Edge::Color color) {
+  static const std::array<std::string, 4> names = {
+      color_to_string(Edge::Color::Red), color_to_string(Edge::Color::Grey),
+      color_to_string(Edge::Color::Green),
+      color_to_string(Edge::Color::Yellow)};
+  return names[static_cast<int>(color)];
+}
+}  // namespace
+
+JsonWriter::JsonWriter(const std::string& filepath)
+    : file_(std::fopen(filepath.c_str(), "wb")), filepath_(filepath) {
+  if (file_ == nullptr) {
+    throw std::runtime_error("Can't open " + filepath_ + " file");
+  }
+  buffer_.reserve(kBufferSize);
+}
+
+JsonWriter::~JsonWriter() {
+  // Best effort: `close` is the way to learn about write errors
+  if (file_ != nullptr) {
+    std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+    std::fclose(file_);
+  }
+}
+
+void JsonWriter::write_graph(const Graph& graph) {
+  write_graph_impl(graph);
+}
+
+void JsonWriter::write_graph(const FrozenGraph& graph) {
+  write_graph_impl(graph);
+}
+
+template <typename GraphType>
+void JsonWriter::write_graph_impl(const GraphType& graph) {
+  write("{\n\"vertices\": [\n");
+  const int vertices_count = graph.vertices_count();
+  for (VertexId vertex_id = 0; vertex_id < vertices_count; ++vertex_id) {
+    if (vertex_id != 0) {
+      write(",\n");
+    }
+    write_vertex(Vertex(vertex_id), graph.get_vertex_depth(vertex_id),
+                 graph.get_connected_edges_ids(vertex_id));
+  }
+  write("\n],\n\"edges\": [\n");
+  const auto& edges = graph.get_edges();
+  for (int index = 0; index < edges.size(); ++index) {
+    if (index != 0) {
+      write(",\n");
+    }
+    write_edge(edges[index]);
+  }
+  write("\n]\n}\n");
+}
+
+void JsonWriter::write_vertex(const Vertex& vertex,
+                              Graph::Depth depth,
+                              ArrayView<EdgeId> connected_edge_ids) {
+  write("{\n  \"id\": ");
+  write(vertex.get_id());
+  write(",\n  \"edge_ids\": [");
+  for (int index = 0; index < connected_edge_ids.size(); ++index) {
+    if (index != 0) {
+      write(", ");
+    }
+    write(connected_edge_ids[index]);
+  }
+  write("],\n  \"depth\": ");
+  write(depth);
+  write("\n}");
+}
+
+void JsonWriter::write_edge(const Edge& edge) {
+  write("{\n  \"id\": ");
+  write(edge.get_id());
+  write(",\n  \"vertex_ids\": [");
+  write(edge.get_first_vertex_id());
+  write(", ");
+  write(edge.get_second_vertex_id());
+  write("],\n  \"color\": \"");
+  write(color_name(edge.get_color()));
+  write("\"\n}");
+}
+
+void JsonWriter::write(std::string_view text) {
+  if (file_ != nullptr && buffer_.size() + text.size() > kBufferSize) {
+    flush();
+    if (text.size() > kBufferSize) {
+      std::fwrite(text.data(), 1, text.size(), file_);
+      return;
+    }
+  }
+  buffer_.append(text);
+}
+
+void JsonWriter::write(int value) {
+  std::array<char, MAX_INT_DIGITS> digits;
+  auto begin = digits.end();
+  // Negated, as -INT_MIN does not fit
+  int rest = value < 0 ? value : -value;
+  do {
+    *--begin = static_cast<char>('0' - rest % 10);
+    rest /= 10;
+  } while (rest != 0);
+  if (value < 0) {
+    *--begin = '-';
+  }
+  write(std::string_view(begin, digits.end() - begin));
+}
+
+void JsonWriter::copy_from(std::FILE* file) {
+  std::array<char, 1 << 16> chunk;
+  for (std::size_t size = 0;
+       (size = std::fread(chunk.data(), 1, chunk.size(), file)) != 0;) {
+    write(std::string_view(chunk.data(), size));
+  }
+}
+
+void JsonWriter::close() {
+  if (file_ == nullptr) {
+    return;
+  }
+  flush();
+  const bool is_failed = std::fclose(file_) != 0;
+  file_ = nullptr;
+  if (is_failed) {
+    throw std::runtime_error("Can't write " + filepath_ + " file");
+  }
+}
+
+std::string JsonWriter::take_string() {
+  return std::exchange(buffer_, std::string());
+}
+
+void JsonWriter::flush() {
+  if (!buffer_.empty() &&
+      std::fwrite(buffer_.data(), 1, buffer_.size(), file_) !=
+          buffer_.size()) {
+    throw std::runtime_error("Can't write " + filepath_ + " file");
+  }
+  buffer_.clear();
+}
+
+}  // namespace json
+}  // namespace printing
+}  // namespace uni_course_cpp
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include "array_view.hpp"
+#include "frozen_graph.hpp"
+#include "graph.hpp"
+
+namespace uni_course_cpp {
+namespace printing {
+namespace json {
+// Streaming writer of the graph JSON format. Text collects in one buffer
+// that is flushed to the output file whenever it fills up, so memory stays
+// at `kBufferSize` however large the graph is; without a file the whole
+// text is kept and handed out by `take_string`. Integers are formatted by
+// hand, without streams or locales.
+class JsonWriter {
+ public:
+  static constexpr std::size_t kBufferSize = 1 << 20;
+
+  // Writes to memory
+  JsonWriter() = default;
+  // Writes to `filepath`, truncating it
+  explicit JsonWriter(const std::string& filepath);
+  ~JsonWriter();
+
+  void write_graph(const Graph& graph);
+  void write_graph(const FrozenGraph& graph);
+  void write_vertex(const Vertex& vertex,
+                    Graph::Depth depth,
+                    ArrayView<EdgeId> connected_edge_ids);
+  void write_edge(const Edge& edge);
+
+  void write(std::string_view text);
+  void write(int value);
+  // Appends everything `file` has left to read
+  void copy_from(std::FILE* file);
+
+  // Flushes the buffer and closes the file; a file writer accepts nothing
+  // afterwards
+  void close();
+  // The text written so far by a memory writer, which is left empty
+  std::string take_string();
+
+ private:
+  template <typename GraphType>
+  void write_graph_impl(const GraphType& graph);
+  void flush();
+
+  std::string buffer_;
+  std::FILE* file_ = nullptr;
+  std::string filepath_;
+
+  JsonWriter(const JsonWriter&) = delete;
+  JsonWriter& operator=(const JsonWriter&) = delete;
+};
+}  // namespace json
+}  // namespace printing
+}  // namespace uni_course_cpp
@@ -0,0 +1,109 @@
+#include "landmark_index.hpp"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+#include <set>
+#include "graph_traverser.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+constexpr int UNREACHABLE = INT_MAX;
+constexpr uni_course_cpp::VertexId FIRST_VERTEX_ID = 0;
+constexpr uni_course_cpp::VertexId NO_VERTEX_ID = -1;
+}  // namespace
+
+namespace uni_course_cpp {
+
+LandmarkIndex::LandmarkIndex(const FrozenGraph& graph, int landmarks_count)
+    : vertices_count_(graph.vertices_count()) {
+  const auto build_start = std::chrono::steady_clock::now();
+  landmarks_count = std::min(landmarks_count, vertices_count_);
+  const GraphTraverser graph_traverser(graph);
+
+  // Hop distance from every vertex to its closest landmark so far
+  std::vector<GraphPath::Distance> closest_distances(vertices_count_,
+                                                     UNREACHABLE);
+  std::vector<std::vector<GraphPath::Distance>> landmark_distances;
+  auto farthest_vertex_id = FIRST_VERTEX_ID;
+  if (landmarks_count > 0) {
+    // The first landmark is the vertex farthest from the root
+    const auto root_distances =
+        graph_traverser.find_distances(FIRST_VERTEX_ID);
+    for (VertexId vertex_id = 0; vertex_id < vertices_count_; ++vertex_id) {
+      if (root_distances[vertex_id] != UNREACHABLE &&
+          root_distances[vertex_id] > root_distances[farthest_vertex_id]) {
+        farthest_vertex_id = vertex_id;
+      }
+    }
+  }
+  for (int index = 0;
+       index < landmarks_count && farthest_vertex_id != NO_VERTEX_ID;
+       ++index) {
+    landmark_ids_.push_back(farthest_vertex_id);
+    landmark_distances.push_back(
+        graph_traverser.find_distances(farthest_vertex_id));
+    for (VertexId vertex_id = 0; vertex_id < vertices_count_; ++vertex_id) {
+      closest_distances[vertex_id] = std::min(
+          closest_distances[vertex_id], landmark_distances.back()[vertex_id]);
+    }
+    // Landmarks are at distance 0 from themselves, so only a reachable
+    // vertex that is not a landmark yet can be picked
+    farthest_vertex_id = NO_VERTEX_ID;
+    for (VertexId vertex_id = 0; vertex_id < vertices_count_; ++vertex_id) {
+      const auto distance = closest_distances[vertex_id];
+      if (distance != UNREACHABLE && distance > 0 &&
+          (farthest_vertex_id == NO_VERTEX_ID ||
+           distance > closest_distances[farthest_vertex_id])) {
+        farthest_vertex_id = vertex_id;
+      }
+    }
+  }
+  // Fewer when the reachable part of the graph runs out of vertices
+  landmarks_count = landmark_ids_.size();
+  assert(std::set<VertexId>(landmark_ids_.begin(), landmark_ids_.end())
+             .size() == landmark_ids_.size());
+
+  std::vector<std::vector<Edge::Duration>> landmark_durations(
+      landmarks_count);
+  ThreadPool::get_thread_pool().parallel_for(
+      0, landmarks_count,
+      [&graph_traverser, &landmark_durations, this](int index) {
+        landmark_durations[index] =
+            graph_traverser.find_durations(landmark_ids_[index]);
+      });
+
+  distances_.resize(vertices_count_ * landmarks_count);
+  durations_.resize(vertices_count_ * landmarks_count);
+  for (VertexId vertex_id = 0; vertex_id < vertices_count_; ++vertex_id) {
+    for (int index = 0; index < landmarks_count; ++index) {
+      distances_[vertex_id * landmarks_count + index] =
+          landmark_distances[index][vertex_id];
+      durations_[vertex_id * landmarks_count + index] =
+          landmark_durations[index][vertex_id];
+    }
+  }
+  build_duration_ = std::chrono::steady_clock::now() - build_start;
+}
+
+int LandmarkIndex::get_bound(const std::vector<int>& values,
+                             VertexId first_vertex_id,
+                             VertexId second_vertex_id) const {
+  const int landmarks_count = landmark_ids_.size();
+  const int* const first_values =
+      values.data() + first_vertex_id * landmarks_count;
+  const int* const second_values =
+      values.data() + second_vertex_id * landmarks_count;
+  int bound = 0;
+  for (int index = 0; index < landmarks_count; ++index) {
+    // A landmark out of reach of either vertex tells nothing
+    if (first_values[index] != UNREACHABLE &&
+        second_values[index] != UNREACHABLE) {
+      bound = std::max(bound,
+                       std::abs(first_values[index] - second_values[index]));
+    }
+  }
+  return bound;
+}
+
+}  // namespace uni_course_cpp
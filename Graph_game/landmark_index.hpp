@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include "frozen_graph.hpp"
+#include "graph_path.hpp"
+
+namespace uni_course_cpp {
+// Precomputed hop distances and durations from a few landmark vertices of
+// a finished map. By the triangle inequality they bound the distance and
+// duration between any two vertices from below in O(landmarks_count);
+// more landmarks give tighter bounds for `8 * landmarks_count` bytes per
+// vertex.
+class LandmarkIndex {
+ public:
+  // Landmarks are picked one by one, each the reachable vertex farthest
+  // (in hops) from those already picked. They are distinct, so there are
+  // fewer than `landmarks_count` when the reachable vertices run out.
+  LandmarkIndex(const FrozenGraph& graph, int landmarks_count);
+
+  int landmarks_count() const { return landmark_ids_.size(); }
+  int vertices_count() const { return vertices_count_; }
+  const std::vector<VertexId>& get_landmark_ids() const {
+    return landmark_ids_;
+  }
+
+  GraphPath::Distance get_distance_bound(VertexId first_vertex_id,
+                                         VertexId second_vertex_id) const {
+    return get_bound(distances_, first_vertex_id, second_vertex_id);
+  }
+  Edge::Duration get_duration_bound(VertexId first_vertex_id,
+                                    VertexId second_vertex_id) const {
+    return get_bound(durations_, first_vertex_id, second_vertex_id);
+  }
+
+  std::size_t size_in_bytes() const {
+    return (distances_.size() + durations_.size()) * sizeof(int);
+  }
+  std::chrono::duration<double> build_duration() const {
+    return build_duration_;
+  }
+
+ private:
+  // `values` is vertex-major, so one bound reads two contiguous rows
+  int get_bound(const std::vector<int>& values,
+                VertexId first_vertex_id,
+                VertexId second_vertex_id) const;
+
+  int vertices_count_ = 0;
+  std::vector<VertexId> landmark_ids_;
+  std::vector<GraphPath::Distance> distances_;
+  std::vector<Edge::Duration> durations_;
+  std::chrono::duration<double> build_duration_{0};
+};
+}  // namespace uni_course_cpp
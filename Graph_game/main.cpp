@@ -1,26 +1,18 @@
 #include <filesystem>
-#include <fstream>
 #include <iostream>
 #include <sstream>
 #include "config.hpp"
 #include "game_generator.hpp"
 #include "graph.hpp"
-#include "graph_generation_controller.hpp"
 #include "graph_generator.hpp"
 #include "graph_json_printing.hpp"
+#include "graph_pipeline.hpp"
 #include "graph_printing.hpp"
-#include "graph_traverser_controller.hpp"
 #include "logger.hpp"
 
-void json_to_file(const std::string& str, const std::string& filepath) {
-  std::ofstream json;
-  json.open(filepath);
-  if (!json.is_open()) {
-    throw std::runtime_error("Can't open graph.json file");
-  }
-  json << str;
-  json.close();
-}
+namespace {
+constexpr int kPipelineQueueCapacity = 4;
+}  // namespace
 
 int handle_depth_input() {
   int depth = 0;
@@ -94,57 +86,38 @@ std::string traversal_started_string(int graph_number) {
 
 std::string traversal_finished_string(
     int graph_number,
-    const std::vector<uni_course_cpp::GraphPath>& pathes) {
+    const uni_course_cpp::ShortestPathTree& paths) {
   std::stringstream output;
-  output << "Graph " << graph_number << ", TraversalFinished, Paths: [\n";
-  for (int index = 0; index < pathes.size(); ++index) {
-    output << "  " << uni_course_cpp::printing::print_path(pathes[index]);
-    if (index != pathes.size() - 1) {
-      output << ",";
-    }
-    output << "\n";
-  }
-  output << "]\n";
+  output << "Graph " << graph_number << ", TraversalFinished, Paths: "
+         << uni_course_cpp::printing::print_shortest_path_tree(paths) << "\n";
   return output.str();
 }
 
-std::vector<uni_course_cpp::Graph> generate_graphs(
-    const uni_course_cpp::GraphGenerator::Params& params,
-    int graphs_count,
-    int threads_count) {
-  auto generation_controller = uni_course_cpp::GraphGenerationController(
-      threads_count, graphs_count, params);
-
-  auto& logger = uni_course_cpp::Logger::get_logger();
-
-  auto graphs = std::vector<uni_course_cpp::Graph>();
-  graphs.reserve(graphs_count);
-
-  generation_controller.generate(
-      [&logger](int index) { logger.log(generation_started_string(index)); },
-      [&logger, &graphs](int index, uni_course_cpp::Graph graph) {
-        const auto graph_description =
-            uni_course_cpp::printing::print_graph(graph);
-        logger.log(generation_finished_string(index, graph_description));
-        const auto graph_json =
-            uni_course_cpp::printing::json::graph_to_string(graph);
-        graphs.push_back(std::move(graph));
-        json_to_file(graph_json,
-                     std::string(uni_course_cpp::config::kTempDirectoryPath) +
-                         "graph_" + std::to_string(index) + ".json");
-      });
-
-  return graphs;
+std::string graph_json_filepath(int graph_number) {
+  return std::string(uni_course_cpp::config::kTempDirectoryPath) + "graph_" +
+         std::to_string(graph_number) + ".json";
 }
 
-void traverse_graphs(const std::vector<uni_course_cpp::Graph>& graphs) {
-  auto traversal_controller = uni_course_cpp::GraphTraversalController(graphs);
+void process_graphs(const uni_course_cpp::GraphGenerator::Params& params,
+                    int graphs_count,
+                    int threads_count) {
+  auto pipeline = uni_course_cpp::GraphPipeline(
+      graphs_count, params, threads_count, kPipelineQueueCapacity);
   auto& logger = uni_course_cpp::Logger::get_logger();
 
-  traversal_controller.traverse(
+  pipeline.run(
+      [&logger](int index) { logger.log(generation_started_string(index)); },
+      [&logger](int index, const uni_course_cpp::Graph& graph) {
+        logger.log(generation_finished_string(
+            index, uni_course_cpp::printing::print_graph(graph)));
+      },
       [&logger](int index) { logger.log(traversal_started_string(index)); },
-      [&logger](int index, std::vector<uni_course_cpp::GraphPath> paths) {
+      [&logger](int index, const uni_course_cpp::ShortestPathTree& paths) {
         logger.log(traversal_finished_string(index, paths));
+      },
+      [](int index, const uni_course_cpp::Graph& graph) {
+        uni_course_cpp::printing::json::graph_to_file(
+            graph, graph_json_filepath(index));
       });
 }
 
@@ -157,16 +130,13 @@ std::string game_ready_string(const uni_course_cpp::Game& game) {
   return output.str();
 }
 
-std::string shortest_path_searching_string() {
-  return "Searching for Shortest Path...";
+std::string paths_searching_string() {
+  return "Searching for Shortest and Fastest Paths...";
 }
+
 std::string shortest_path_ready_string(const uni_course_cpp::GraphPath& path) {
   return "Shortest Path: " + uni_course_cpp::printing::print_path(path);
 }
-
-std::string fastest_path_searching_string() {
-  return "Searching for Fastest Path...";
-}
 std::string fastest_path_ready_string(const uni_course_cpp::GraphPath& path) {
   return "Fastest Path: " + uni_course_cpp::printing::print_path(path);
 }
@@ -184,20 +154,14 @@ int main() {
   const auto game = game_generator.generate();
 
   logger.log(game_ready_string(game));
-  logger.log(shortest_path_searching_string());
-
-  const auto shortest_path = game.find_shortest_path();
-
-  logger.log(shortest_path_ready_string(shortest_path));
-  logger.log(fastest_path_searching_string());
+  logger.log(paths_searching_string());
 
-  const auto fastest_path = game.find_fastest_path();
+  const auto paths = game.find_shortest_and_fastest_paths();
 
-  logger.log(fastest_path_ready_string(fastest_path));
+  logger.log(shortest_path_ready_string(paths.shortest_path));
+  logger.log(fastest_path_ready_string(paths.fastest_path));
 
-  const auto map_json =
-      uni_course_cpp::printing::json::graph_to_string(game.map());
-  json_to_file(map_json, "map.json");
+  uni_course_cpp::printing::json::graph_to_file(game.map(), "map.json");
 
   return 0;
 }
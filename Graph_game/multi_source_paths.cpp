@@ -0,0 +1,151 @@
+#include "multi_source_paths.hpp"
+#include <algorithm>
+#include <cassert>
+#include "thread_pool.hpp"
+
+namespace {
+constexpr int NO_SLOT = -1;
+}  // namespace
+
+namespace uni_course_cpp {
+
+MultiSourcePaths::MultiSourcePaths(const FrozenGraph& graph,
+                                   ArrayView<VertexId> source_vertex_ids,
+                                   ArrayView<VertexId> destination_vertex_ids)
+    : graph_(graph),
+      source_vertex_ids_(source_vertex_ids.to_vector()),
+      batches_((source_vertex_ids.size() + kBatchSize - 1) / kBatchSize) {
+  std::vector<int> vertex_slots(graph_.vertices_count(), NO_SLOT);
+  destination_slots_.reserve(destination_vertex_ids.size());
+  for (const auto vertex_id : destination_vertex_ids) {
+    if (vertex_slots[vertex_id] == NO_SLOT) {
+      vertex_slots[vertex_id] = slot_vertex_ids_.size();
+      slot_vertex_ids_.push_back(vertex_id);
+    }
+    destination_slots_.push_back(vertex_slots[vertex_id]);
+  }
+  ThreadPool::get_thread_pool().parallel_for(
+      0, batches_.size(), [&vertex_slots, this](int batch_index) {
+        search_batch(batch_index, vertex_slots);
+      });
+}
+
+void MultiSourcePaths::search_batch(int batch_index,
+                                    const std::vector<int>& vertex_slots) {
+  auto& batch = batches_[batch_index];
+  const int first_source_index = batch_index * kBatchSize;
+  const int batch_size =
+      std::min(kBatchSize, sources_count() - first_source_index);
+  const auto batch_mask = batch_size == kBatchSize
+                              ? ~SourceMask{0}
+                              : (SourceMask{1} << batch_size) - 1;
+  batch.distances.assign(slot_vertex_ids_.size() * kBatchSize, kMaxDistance);
+
+  // Sources that have reached each vertex, and those reaching it at the
+  // distance being expanded
+  std::vector<SourceMask> seen_masks(graph_.vertices_count(), 0);
+  std::vector<SourceMask> next_masks(graph_.vertices_count(), 0);
+  std::vector<VertexId> next_vertex_ids;
+  int pending_slots_count = slot_vertex_ids_.size();
+  const auto close_level = [&](GraphPath::Distance distance) {
+    std::sort(next_vertex_ids.begin(), next_vertex_ids.end());
+    auto& level = batch.levels.emplace_back();
+    level.reserve(next_vertex_ids.size());
+    for (const auto vertex_id : next_vertex_ids) {
+      const auto mask = next_masks[vertex_id];
+      next_masks[vertex_id] = 0;
+      seen_masks[vertex_id] |= mask;
+      level.emplace_back(vertex_id, mask);
+
+      const auto slot = vertex_slots[vertex_id];
+      if (slot == NO_SLOT) {
+        continue;
+      }
+      for (auto bits = mask; bits != 0; bits &= bits - 1) {
+        batch.distances[slot * kBatchSize + __builtin_ctzll(bits)] = distance;
+      }
+      if (seen_masks[vertex_id] == batch_mask) {
+        --pending_slots_count;
+      }
+    }
+    next_vertex_ids.clear();
+  };
+
+  for (int bit = 0; bit < batch_size; ++bit) {
+    const auto vertex_id = source_vertex_ids_[first_source_index + bit];
+    if (next_masks[vertex_id] == 0) {
+      next_vertex_ids.push_back(vertex_id);
+    }
+    next_masks[vertex_id] |= SourceMask{1} << bit;
+  }
+  close_level(0);
+  // One pass over the edges of a frontier vertex advances every source of
+  // the batch that reached it at this distance
+  for (GraphPath::Distance distance = 1;
+       !batch.levels.back().empty() && pending_slots_count > 0; ++distance) {
+    for (const auto& [vertex_id, mask] : batch.levels.back()) {
+      for (const auto next_vertex_id : graph_.get_neighbor_ids(vertex_id)) {
+        const auto new_mask = mask & ~seen_masks[next_vertex_id];
+        if (new_mask == 0) {
+          continue;
+        }
+        if (next_masks[next_vertex_id] == 0) {
+          next_vertex_ids.push_back(next_vertex_id);
+        }
+        next_masks[next_vertex_id] |= new_mask;
+      }
+    }
+    close_level(distance);
+  }
+  if (batch.levels.back().empty()) {
+    batch.levels.pop_back();
+  }
+}
+
+GraphPath::Distance MultiSourcePaths::get_distance(
+    int source_index,
+    int destination_index) const {
+  const auto& batch = batches_[source_index / kBatchSize];
+  return batch.distances[destination_slots_[destination_index] * kBatchSize +
+                         source_index % kBatchSize];
+}
+
+GraphPath MultiSourcePaths::get_path(int source_index,
+                                     int destination_index) const {
+  const auto distance = get_distance(source_index, destination_index);
+  if (distance == kMaxDistance) {
+    return GraphPath(0, {}, {});
+  }
+  const auto& levels = batches_[source_index / kBatchSize].levels;
+  const auto source_mask = SourceMask{1} << (source_index % kBatchSize);
+
+  std::vector<VertexId> vertex_ids(distance + 1);
+  std::vector<EdgeId> edge_ids(distance);
+  Edge::Duration duration = 0;
+  vertex_ids[distance] =
+      slot_vertex_ids_[destination_slots_[destination_index]];
+  // Steps back to any neighbor the source reached one level earlier
+  for (int index = distance - 1; index >= 0; --index) {
+    const auto& level = levels[index];
+    const auto vertex_id = vertex_ids[index + 1];
+    const auto connected_edge_ids = graph_.get_connected_edges_ids(vertex_id);
+    const auto neighbor_ids = graph_.get_neighbor_ids(vertex_id);
+    int slot = 0;
+    for (; slot < neighbor_ids.size(); ++slot) {
+      const auto found = std::lower_bound(
+          level.begin(), level.end(),
+          std::make_pair(neighbor_ids[slot], SourceMask{0}));
+      if (found != level.end() && found->first == neighbor_ids[slot] &&
+          (found->second & source_mask) != 0) {
+        break;
+      }
+    }
+    assert(slot < neighbor_ids.size());
+    vertex_ids[index] = neighbor_ids[slot];
+    edge_ids[index] = connected_edge_ids[slot];
+    duration += graph_.get_edge(edge_ids[index]).get_duration();
+  }
+  return GraphPath(duration, std::move(vertex_ids), std::move(edge_ids));
+}
+
+}  // namespace uni_course_cpp
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <climits>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "array_view.hpp"
+#include "frozen_graph.hpp"
+#include "graph_path.hpp"
+
+namespace uni_course_cpp {
+// Hop distances and shortest paths from every source to every destination,
+// found by bit-parallel breadth-first searches over batches of sources.
+// Refers to `graph`, which must outlive it.
+class MultiSourcePaths {
+ public:
+  // Sources searched together, one bit of a `SourceMask` each
+  static constexpr int kBatchSize = 64;
+  using SourceMask = uint64_t;
+  static constexpr GraphPath::Distance kMaxDistance = INT_MAX;
+
+  MultiSourcePaths(const FrozenGraph& graph,
+                   ArrayView<VertexId> source_vertex_ids,
+                   ArrayView<VertexId> destination_vertex_ids);
+
+  int sources_count() const { return source_vertex_ids_.size(); }
+  int destinations_count() const { return destination_slots_.size(); }
+
+  // `kMaxDistance` when the destination is unreachable
+  GraphPath::Distance get_distance(int source_index,
+                                   int destination_index) const;
+  // Empty path when the destination is unreachable
+  GraphPath get_path(int source_index, int destination_index) const;
+
+ private:
+  // Vertices first reached at one distance, sorted by id, each with the
+  // sources of the batch that reach it there
+  using Level = std::vector<std::pair<VertexId, SourceMask>>;
+
+  struct Batch {
+    std::vector<Level> levels;
+    // Indexed by `destination slot * kBatchSize + source bit`
+    std::vector<GraphPath::Distance> distances;
+  };
+
+  // `vertex_slots[v]` is the destination slot of vertex `v`, or -1
+  void search_batch(int batch_index, const std::vector<int>& vertex_slots);
+
+  const FrozenGraph& graph_;
+  std::vector<VertexId> source_vertex_ids_;
+  // Equal destinations share a slot
+  std::vector<int> destination_slots_;
+  std::vector<VertexId> slot_vertex_ids_;
+  std::vector<Batch> batches_;
+};
+}  // namespace uni_course_cpp
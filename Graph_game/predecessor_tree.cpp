@@ -0,0 +1,62 @@
+#include "predecessor_tree.hpp"
+#include <utility>
+
+namespace uni_course_cpp {
+
+PredecessorTree::PredecessorTree(const std::vector<Edge>& edges,
+                                 VertexId root_vertex_id,
+                                 const std::vector<EdgeId>& parent_edge_ids)
+    : root_vertex_id_(root_vertex_id), links_(parent_edge_ids.size()) {
+  for (VertexId vertex_id = 0; vertex_id < links_.size(); ++vertex_id) {
+    const auto edge_id = parent_edge_ids[vertex_id];
+    if (vertex_id == root_vertex_id || edge_id == kNoEdgeId) {
+      continue;
+    }
+    const auto& edge = edges[edge_id];
+    links_[vertex_id].parent_vertex_id =
+        edge.get_first_vertex_id() + edge.get_second_vertex_id() - vertex_id;
+    links_[vertex_id].edge_id = edge_id;
+  }
+
+  // Totals are filled parent first. Every walk up stops at the first vertex
+  // done before, so all of them together visit each vertex once.
+  std::vector<bool> is_done(links_.size(), false);
+  is_done[root_vertex_id] = true;
+  std::vector<VertexId> pending_vertex_ids;
+  for (VertexId vertex_id = 0; vertex_id < links_.size(); ++vertex_id) {
+    if (!is_reached(vertex_id)) {
+      continue;
+    }
+    for (VertexId current_id = vertex_id; !is_done[current_id];
+         current_id = links_[current_id].parent_vertex_id) {
+      pending_vertex_ids.push_back(current_id);
+    }
+    while (!pending_vertex_ids.empty()) {
+      auto& link = links_[pending_vertex_ids.back()];
+      const auto& parent_link = links_[link.parent_vertex_id];
+      link.distance = parent_link.distance + 1;
+      link.duration = parent_link.duration + edges[link.edge_id].get_duration();
+      is_done[pending_vertex_ids.back()] = true;
+      pending_vertex_ids.pop_back();
+    }
+  }
+}
+
+GraphPath PredecessorTree::get_path(VertexId vertex_id) const {
+  if (!is_reached(vertex_id)) {
+    return GraphPath(0, {}, {});
+  }
+  const int edges_count = links_[vertex_id].distance;
+  std::vector<VertexId> vertex_ids(edges_count + 1);
+  std::vector<EdgeId> edge_ids(edges_count);
+  vertex_ids[edges_count] = vertex_id;
+  for (int index = edges_count - 1; index >= 0; --index) {
+    const auto& link = links_[vertex_ids[index + 1]];
+    edge_ids[index] = link.edge_id;
+    vertex_ids[index] = link.parent_vertex_id;
+  }
+  return GraphPath(links_[vertex_id].duration, std::move(vertex_ids),
+                   std::move(edge_ids));
+}
+
+}  // namespace uni_course_cpp
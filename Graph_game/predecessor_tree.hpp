@@ -0,0 +1,102 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include "graph.hpp"
+#include "graph_path.hpp"
+
+namespace uni_course_cpp {
+// Parent links of one search from `root_vertex_id`, shared by every
+// `CompactGraphPath` that ends in it, with the edge count and duration of
+// the tree path to every vertex. Holds no reference to the graph.
+class PredecessorTree {
+ public:
+  static constexpr VertexId kNoVertexId = -1;
+  static constexpr EdgeId kNoEdgeId = -1;
+
+  // `parent_edge_ids[v]` is the edge `v` was reached by, `kNoEdgeId` for
+  // the root and for unreached vertices. Takes O(V) in total.
+  PredecessorTree(const std::vector<Edge>& edges,
+                  VertexId root_vertex_id,
+                  const std::vector<EdgeId>& parent_edge_ids);
+
+  VertexId root_vertex_id() const { return root_vertex_id_; }
+  int vertices_count() const { return links_.size(); }
+  bool is_reached(VertexId vertex_id) const {
+    return vertex_id == root_vertex_id_ ||
+           links_[vertex_id].edge_id != kNoEdgeId;
+  }
+  VertexId get_parent_id(VertexId vertex_id) const {
+    return links_[vertex_id].parent_vertex_id;
+  }
+  EdgeId get_parent_edge_id(VertexId vertex_id) const {
+    return links_[vertex_id].edge_id;
+  }
+  // Along the tree path from the root, 0 for unreached vertices
+  GraphPath::Distance get_distance(VertexId vertex_id) const {
+    return links_[vertex_id].distance;
+  }
+  Edge::Duration get_duration(VertexId vertex_id) const {
+    return links_[vertex_id].duration;
+  }
+
+  // Empty path when `vertex_id` is unreached
+  GraphPath get_path(VertexId vertex_id) const;
+
+ private:
+  struct Link {
+    VertexId parent_vertex_id = kNoVertexId;
+    EdgeId edge_id = kNoEdgeId;
+    GraphPath::Distance distance = 0;
+    Edge::Duration duration = 0;
+  };
+
+  VertexId root_vertex_id_ = kNoVertexId;
+  std::vector<Link> links_;
+};
+
+// Path from the root of a shared `PredecessorTree` to one vertex, stored
+// as that vertex alone. Creating or copying it is O(1) and copies no vertex
+// or edge lists; only `to_graph_path` and `for_each_vertex_backward` walk
+// the tree.
+class CompactGraphPath {
+ public:
+  // Empty when `destination_vertex_id` is unreached in `tree`
+  CompactGraphPath(std::shared_ptr<const PredecessorTree> tree,
+                   VertexId destination_vertex_id)
+      : tree_(std::move(tree)), destination_vertex_id_(destination_vertex_id) {}
+
+  VertexId source_vertex_id() const { return tree_->root_vertex_id(); }
+  VertexId destination_vertex_id() const { return destination_vertex_id_; }
+  GraphPath::Distance distance() const {
+    return tree_->get_distance(destination_vertex_id_);
+  }
+  Edge::Duration duration() const {
+    return tree_->get_duration(destination_vertex_id_);
+  }
+  bool empty() const { return !tree_->is_reached(destination_vertex_id_); }
+
+  // Calls `visitor(vertex_id)` for every vertex, from the destination back
+  // to the source
+  template <typename Visitor>
+  void for_each_vertex_backward(const Visitor& visitor) const {
+    if (empty()) {
+      return;
+    }
+    for (VertexId vertex_id = destination_vertex_id_;
+         vertex_id != PredecessorTree::kNoVertexId;
+         vertex_id = tree_->get_parent_id(vertex_id)) {
+      visitor(vertex_id);
+    }
+  }
+
+  GraphPath to_graph_path() const {
+    return tree_->get_path(destination_vertex_id_);
+  }
+
+ private:
+  std::shared_ptr<const PredecessorTree> tree_;
+  VertexId destination_vertex_id_ = PredecessorTree::kNoVertexId;
+};
+}  // namespace uni_course_cpp
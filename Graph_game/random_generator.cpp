@@ -0,0 +1,72 @@
+#include "random_generator.hpp"
+#include <random>
+
+namespace {
+constexpr std::uint64_t kGoldenGamma = 0x9e3779b97f4a7c15ULL;
+
+std::uint64_t split_mix(std::uint64_t& state) {
+  std::uint64_t result = (state += kGoldenGamma);
+  result = (result ^ (result >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  result = (result ^ (result >> 27)) * 0x94d049bb133111ebULL;
+  return result ^ (result >> 31);
+}
+
+std::uint64_t rotate_left(std::uint64_t value, int shift) {
+  return (value << shift) | (value >> (64 - shift));
+}
+}  // namespace
+
+namespace uni_course_cpp {
+
+RandomGenerator::RandomGenerator(Seed seed) : seed_(seed) {
+  auto split_mix_state = seed;
+  for (auto& word : state_) {
+    word = split_mix(split_mix_state);
+  }
+}
+
+RandomGenerator::Seed RandomGenerator::random_seed() {
+  std::random_device random_device;
+  return (static_cast<Seed>(random_device()) << 32) ^ random_device();
+}
+
+RandomGenerator RandomGenerator::split(std::uint64_t stream_id) const {
+  auto split_mix_state = seed_ ^ rotate_left(stream_id * kGoldenGamma, 17);
+  split_mix(split_mix_state);
+  return RandomGenerator(split_mix(split_mix_state));
+}
+
+std::uint64_t RandomGenerator::next() {
+  const auto result = rotate_left(state_[1] * 5, 7) * 9;
+  const auto shifted = state_[1] << 17;
+  state_[2] ^= state_[0];
+  state_[3] ^= state_[1];
+  state_[1] ^= state_[2];
+  state_[0] ^= state_[3];
+  state_[2] ^= shifted;
+  state_[3] = rotate_left(state_[3], 45);
+  return result;
+}
+
+int RandomGenerator::get_random(int start, int end) {
+  // Lemire's multiply-shift with rejection: unbiased, usually no division.
+  // The range of an `int` interval fits in 32 bits, so the product fits 64.
+  const auto range =
+      static_cast<std::uint64_t>(static_cast<std::int64_t>(end) - start) + 1;
+  auto product = (next() >> 32) * range;
+  auto low = static_cast<std::uint32_t>(product);
+  if (low < range) {
+    const auto threshold = static_cast<std::uint32_t>((1ULL << 32) % range);
+    while (low < threshold) {
+      product = (next() >> 32) * range;
+      low = static_cast<std::uint32_t>(product);
+    }
+  }
+  return start + static_cast<int>(product >> 32);
+}
+
+bool RandomGenerator::check_probability(double probability) {
+  return static_cast<double>(next() >> 11) * 0x1.0p-53 < probability;
+}
+
+}  // namespace uni_course_cpp
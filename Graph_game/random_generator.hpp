@@ -0,0 +1,36 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace uni_course_cpp {
+// Small, fast, seedable generator (xoshiro256**). Generators are cheap to
+// copy, so each thread or job should own one obtained with `split`: streams
+// derived from the same seed and stream id are always identical.
+class RandomGenerator {
+ public:
+  using Seed = std::uint64_t;
+  using result_type = std::uint64_t;
+
+  explicit RandomGenerator(Seed seed);
+
+  // Seed drawn from `std::random_device`, for non-reproducible runs
+  static Seed random_seed();
+
+  RandomGenerator split(std::uint64_t stream_id) const;
+  Seed seed() const { return seed_; }
+
+  std::uint64_t next();
+  // Uniform integer in the closed range [start, end]
+  int get_random(int start, int end);
+  bool check_probability(double probability);
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return UINT64_MAX; }
+  result_type operator()() { return next(); }
+
+ private:
+  Seed seed_ = 0;
+  std::array<std::uint64_t, 4> state_ = {};
+};
+}  // namespace uni_course_cpp
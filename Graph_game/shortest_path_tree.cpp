@@ -0,0 +1,28 @@
+#include "shortest_path_tree.hpp"
+
+namespace uni_course_cpp {
+
+std::vector<VertexId> ShortestPathTree::get_path_vertex_ids() const {
+  std::vector<bool> is_on_path(tree_->vertices_count(), false);
+  for (const auto target_vertex_id : target_vertex_ids_) {
+    if (!tree_->is_reached(target_vertex_id)) {
+      continue;
+    }
+    // Stops at the first vertex a previous target already marked
+    for (VertexId vertex_id = target_vertex_id;
+         vertex_id != PredecessorTree::kNoVertexId && !is_on_path[vertex_id];
+         vertex_id = tree_->get_parent_id(vertex_id)) {
+      is_on_path[vertex_id] = true;
+    }
+  }
+
+  std::vector<VertexId> vertex_ids;
+  for (VertexId vertex_id = 0; vertex_id < is_on_path.size(); ++vertex_id) {
+    if (is_on_path[vertex_id]) {
+      vertex_ids.push_back(vertex_id);
+    }
+  }
+  return vertex_ids;
+}
+
+}  // namespace uni_course_cpp
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "predecessor_tree.hpp"
+
+namespace uni_course_cpp {
+// Result of one search that serves many targets: the predecessor tree and
+// the targets, with each target's path produced on demand. Takes O(V)
+// memory however many targets share the tree.
+class ShortestPathTree {
+ public:
+  class PathIterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = CompactGraphPath;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = CompactGraphPath;
+
+    PathIterator(const ShortestPathTree& tree, int index)
+        : tree_(&tree), index_(index) {}
+
+    CompactGraphPath operator*() const { return tree_->get_path(index_); }
+    PathIterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    bool operator==(const PathIterator& other) const {
+      return index_ == other.index_;
+    }
+    bool operator!=(const PathIterator& other) const {
+      return index_ != other.index_;
+    }
+
+   private:
+    const ShortestPathTree* tree_;
+    int index_;
+  };
+
+  ShortestPathTree(std::shared_ptr<const PredecessorTree> tree,
+                   std::vector<VertexId> target_vertex_ids)
+      : tree_(std::move(tree)),
+        target_vertex_ids_(std::move(target_vertex_ids)) {}
+
+  const PredecessorTree& tree() const { return *tree_; }
+  VertexId source_vertex_id() const { return tree_->root_vertex_id(); }
+  const std::vector<VertexId>& target_vertex_ids() const {
+    return target_vertex_ids_;
+  }
+  int size() const { return target_vertex_ids_.size(); }
+
+  // Path to the `index`-th target, empty when it is unreached
+  CompactGraphPath get_path(int index) const {
+    return CompactGraphPath(tree_, target_vertex_ids_[index]);
+  }
+  PathIterator begin() const { return PathIterator(*this, 0); }
+  PathIterator end() const { return PathIterator(*this, size()); }
+
+  // Vertices lying on the path to at least one target, in increasing order
+  std::vector<VertexId> get_path_vertex_ids() const;
+
+ private:
+  std::shared_ptr<const PredecessorTree> tree_;
+  std::vector<VertexId> target_vertex_ids_;
+};
+}  // namespace uni_course_cpp
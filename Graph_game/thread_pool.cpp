@@ -0,0 +1,187 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace {
+// Pool and queue index of the current thread, if it is a pool worker
+thread_local const uni_course_cpp::ThreadPool* current_thread_pool = nullptr;
+thread_local int current_worker_index = -1;
+}  // namespace
+
+namespace uni_course_cpp {
+
+ThreadPool::ThreadPool(int threads_count) {
+  threads_count = std::max(threads_count, 1);
+  for (int index = 0; index < threads_count; ++index) {
+    queues_.push_back(std::make_unique<WorkerQueue>());
+  }
+  threads_.reserve(threads_count);
+  for (int index = 0; index < threads_count; ++index) {
+    threads_.emplace_back([this, index]() { run_worker(index); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    const std::lock_guard lock(state_mutex_);
+    should_terminate_ = true;
+  }
+  state_changed_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::notify_all() {
+  // Taking the lock orders the notification after any waiter's check
+  { const std::lock_guard lock(state_mutex_); }
+  state_changed_.notify_all();
+}
+
+void ThreadPool::submit(Task task) {
+  const auto queue_index = current_thread_pool == this
+                               ? current_worker_index
+                               : next_queue_index_++ % queues_.size();
+  {
+    auto& queue = *queues_[queue_index];
+    const std::lock_guard lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  {
+    const std::lock_guard lock(state_mutex_);
+    queued_tasks_++;
+  }
+  state_changed_.notify_one();
+}
+
+bool ThreadPool::try_run_task() {
+  Task task;
+  if (current_thread_pool == this) {
+    auto& queue = *queues_[current_worker_index];
+    const std::lock_guard lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+  }
+  const int queues_count = queues_.size();
+  const int first_victim = current_thread_pool == this
+                               ? current_worker_index + 1
+                               : next_queue_index_.load();
+  for (int offset = 0; !task && offset < queues_count; ++offset) {
+    auto& queue = *queues_[(first_victim + offset) % queues_count];
+    const std::lock_guard lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+  }
+  if (!task) {
+    return false;
+  }
+  queued_tasks_--;
+  task();
+  return true;
+}
+
+void ThreadPool::run_worker(int worker_index) {
+  current_thread_pool = this;
+  current_worker_index = worker_index;
+  while (true) {
+    if (try_run_task()) {
+      continue;
+    }
+    std::unique_lock lock(state_mutex_);
+    state_changed_.wait(
+        lock, [this]() { return should_terminate_ || queued_tasks_ > 0; });
+    if (should_terminate_) {
+      return;
+    }
+  }
+}
+
+void ThreadPool::TaskGroup::run(Task task) {
+  pending_tasks_++;
+  // The group may be destroyed as soon as the counter drops to zero, so the
+  // task must not touch `this` afterwards
+  thread_pool_.submit([&group = *this, &pending_tasks = pending_tasks_,
+                       &thread_pool = thread_pool_, task = std::move(task)]() {
+    try {
+      task();
+    } catch (...) {
+      const std::lock_guard lock(group.exception_mutex_);
+      if (!group.exception_) {
+        group.exception_ = std::current_exception();
+      }
+    }
+    if (--pending_tasks == 0) {
+      thread_pool.notify_all();
+    }
+  });
+}
+
+void ThreadPool::TaskGroup::wait() {
+  wait_for_tasks();
+  std::exception_ptr exception;
+  {
+    const std::lock_guard lock(exception_mutex_);
+    exception = std::exchange(exception_, nullptr);
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+void ThreadPool::TaskGroup::wait_for_tasks() {
+  while (pending_tasks_ > 0) {
+    if (thread_pool_.try_run_task()) {
+      continue;
+    }
+    std::unique_lock lock(thread_pool_.state_mutex_);
+    thread_pool_.state_changed_.wait(lock, [this]() {
+      return pending_tasks_ == 0 || thread_pool_.queued_tasks_ > 0;
+    });
+  }
+}
+
+void ThreadPool::parallel_for(int begin,
+                              int end,
+                              const std::function<void(int index)>& job,
+                              int max_parallelism) {
+  if (begin >= end) {
+    return;
+  }
+  if (max_parallelism <= 0) {
+    max_parallelism = threads_count();
+  }
+  const int tasks_count = std::min(end - begin, max_parallelism);
+  std::atomic<int> next_index = begin;
+  const auto run_jobs = [&next_index, &job, end]() {
+    for (int index = next_index++; index < end; index = next_index++) {
+      try {
+        job(index);
+      } catch (...) {
+        // Leaves nothing for the other tasks to start
+        next_index = end;
+        throw;
+      }
+    }
+  };
+
+  TaskGroup task_group(*this);
+  for (int task_number = 1; task_number < tasks_count; ++task_number) {
+    task_group.run(run_jobs);
+  }
+  std::exception_ptr exception;
+  try {
+    run_jobs();
+  } catch (...) {
+    exception = std::current_exception();
+  }
+  task_group.wait();
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+}  // namespace uni_course_cpp
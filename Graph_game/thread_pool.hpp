@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace uni_course_cpp {
+// Work-stealing pool shared by the whole process. Every worker owns a
+// deque: it pushes and pops its own tasks at the back while idle workers
+// steal from the front. Idle workers sleep instead of spinning, and a thread
+// waiting for a `TaskGroup` runs queued tasks meanwhile, so nested
+// parallelism neither deadlocks nor oversubscribes the machine.
+class ThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  static ThreadPool& get_thread_pool() {
+    static ThreadPool thread_pool(std::thread::hardware_concurrency());
+    return thread_pool;
+  }
+
+  explicit ThreadPool(int threads_count);
+  ~ThreadPool();
+
+  int threads_count() const { return threads_.size(); }
+
+  // Set of tasks that can be waited for as a whole
+  class TaskGroup {
+   public:
+    explicit TaskGroup(ThreadPool& thread_pool = get_thread_pool())
+        : thread_pool_(thread_pool) {}
+    ~TaskGroup() { wait_for_tasks(); }
+
+    void run(Task task);
+    // Rethrows the first exception thrown by a task of the group, once all
+    // of them are done
+    void wait();
+
+   private:
+    void wait_for_tasks();
+
+    ThreadPool& thread_pool_;
+    std::atomic<int> pending_tasks_ = 0;
+    std::mutex exception_mutex_;
+    std::exception_ptr exception_;
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+  };
+
+  // Calls `job(index)` for every index in [begin, end) using at most
+  // `max_parallelism` tasks (0 means one per worker) and returns when all
+  // calls are done. Once a call throws, no further indices are started and
+  // the first exception is rethrown here.
+  void parallel_for(int begin,
+                    int end,
+                    const std::function<void(int index)>& job,
+                    int max_parallelism = 0);
+
+ private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void submit(Task task);
+  bool try_run_task();
+  void run_worker(int worker_index);
+  void notify_all();
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<int> queued_tasks_ = 0;
+  std::atomic<unsigned> next_queue_index_ = 0;
+  std::mutex state_mutex_;
+  // Signalled when a task is queued or a `TaskGroup` becomes empty
+  std::condition_variable state_changed_;
+  bool should_terminate_ = false;
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+};
+}  // namespace uni_course_cpp
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "frozen_graph.hpp"
+#include "graph.hpp"
+#include "thread_pool.hpp"
+
+namespace uni_course_cpp {
+namespace traversal {
+// Cost of an unreached vertex
+constexpr int kMaxCost = INT_MAX;
+constexpr VertexId kNoVertexId = -1;
+constexpr EdgeId kNoEdgeId = -1;
+// Returned by a weight policy for an edge the search must not use
+constexpr int kImpassable = -1;
+
+// Queue disciplines of `search`: first-in first-out for edges of equal
+// weight, circular buckets for small integer weights, a binary heap for
+// anything else
+enum class QueuePolicy { Fifo, Bucket, Heap };
+
+// Weight policies map an edge to its non-negative cost, or `kImpassable`,
+// and name the queue that suits their weights in `kQueuePolicy`. Those with
+// `kFiltersColors` also restrict the search to `allowed_colors()`, which is
+// tested against `FrozenGraph::get_connected_edge_colors` before the weight
+// is looked at.
+struct HopWeight {
+  static constexpr QueuePolicy kQueuePolicy = QueuePolicy::Fifo;
+  static constexpr bool kFiltersColors = false;
+  int operator()(const Edge&) const { return 1; }
+};
+
+struct DurationWeight {
+  static constexpr QueuePolicy kQueuePolicy = QueuePolicy::Bucket;
+  static constexpr bool kFiltersColors = false;
+  int operator()(const Edge& edge) const { return edge.get_duration(); }
+};
+
+// `Weight` restricted to edges of the colors in `allowed_colors`
+template <typename Weight>
+class ColorFilteredWeight {
+ public:
+  static constexpr QueuePolicy kQueuePolicy = Weight::kQueuePolicy;
+  static constexpr bool kFiltersColors = true;
+
+  explicit ColorFilteredWeight(FrozenGraph::ColorMask allowed_colors,
+                               Weight weight = Weight())
+      : weight_(std::move(weight)), allowed_colors_(allowed_colors) {}
+
+  FrozenGraph::ColorMask allowed_colors() const { return allowed_colors_; }
+  int operator()(const Edge& edge) const { return weight_(edge); }
+
+ private:
+  Weight weight_;
+  FrozenGraph::ColorMask allowed_colors_ = FrozenGraph::kAllColors;
+};
+
+// Any callable from `const Edge&` to a cost; nothing is known about the
+// weights, so it gets the heap
+template <typename Function>
+class FunctorWeight {
+ public:
+  static constexpr QueuePolicy kQueuePolicy = QueuePolicy::Heap;
+  static constexpr bool kFiltersColors = false;
+
+  explicit FunctorWeight(Function function) : function_(std::move(function)) {}
+
+  int operator()(const Edge& edge) const { return function_(edge); }
+
+ private:
+  Function function_;
+};
+
+template <typename Function>
+FunctorWeight<Function> make_functor_weight(Function function) {
+  return FunctorWeight<Function>(std::move(function));
+}
+
+template <typename Weight>
+FrozenGraph::ColorMask get_allowed_colors(const Weight& weight) {
+  if constexpr (Weight::kFiltersColors) {
+    return weight.allowed_colors();
+  } else {
+    return FrozenGraph::kAllColors;
+  }
+}
+
+struct NoLowerBound {
+  int operator()(VertexId) const { return 0; }
+};
+
+// Entries are (key, vertex) pairs; keys pushed must never decrease
+class FifoQueue {
+ public:
+  explicit FifoQueue(std::vector<std::pair<int, VertexId>>& entries)
+      : entries_(entries) {}
+  ~FifoQueue() { entries_.clear(); }
+
+  void push(VertexId vertex_id, int key) {
+    entries_.emplace_back(key, vertex_id);
+  }
+  bool pop(VertexId& vertex_id, int& key) {
+    if (head_ == entries_.size()) {
+      return false;
+    }
+    key = entries_[head_].first;
+    vertex_id = entries_[head_].second;
+    ++head_;
+    return true;
+  }
+
+ private:
+  std::vector<std::pair<int, VertexId>>& entries_;
+  int head_ = 0;
+};
+
+// A key waits in `buckets[key % buckets.size()]`, so keys pushed must stay
+// less than `buckets.size()` above the last one popped
+class BucketQueue {
+ public:
+  explicit BucketQueue(std::vector<std::vector<VertexId>>& buckets)
+      : buckets_(buckets) {}
+  ~BucketQueue() {
+    for (auto& bucket : buckets_) {
+      bucket.clear();
+    }
+  }
+
+  void push(VertexId vertex_id, int key) {
+    if (queued_count_ == 0 || key < current_key_) {
+      current_key_ = key;
+    }
+    buckets_[key % buckets_.size()].push_back(vertex_id);
+    ++queued_count_;
+  }
+  bool pop(VertexId& vertex_id, int& key) {
+    if (queued_count_ == 0) {
+      return false;
+    }
+    auto* bucket = &buckets_[current_key_ % buckets_.size()];
+    while (bucket->empty()) {
+      ++current_key_;
+      bucket = &buckets_[current_key_ % buckets_.size()];
+    }
+    vertex_id = bucket->back();
+    bucket->pop_back();
+    key = current_key_;
+    --queued_count_;
+    return true;
+  }
+
+ private:
+  std::vector<std::vector<VertexId>>& buckets_;
+  int current_key_ = 0;
+  int queued_count_ = 0;
+};
+
+class HeapQueue {
+ public:
+  explicit HeapQueue(std::vector<std::pair<int, VertexId>>& entries)
+      : entries_(entries) {}
+  ~HeapQueue() { entries_.clear(); }
+
+  void push(VertexId vertex_id, int key) {
+    entries_.emplace_back(key, vertex_id);
+    std::push_heap(entries_.begin(), entries_.end(), std::greater<>());
+  }
+  bool pop(VertexId& vertex_id, int& key) {
+    if (entries_.empty()) {
+      return false;
+    }
+    std::pop_heap(entries_.begin(), entries_.end(), std::greater<>());
+    key = entries_.back().first;
+    vertex_id = entries_.back().second;
+    entries_.pop_back();
+    return true;
+  }
+
+ private:
+  std::vector<std::pair<int, VertexId>>& entries_;
+};
+
+// Arrays of one search, indexed by vertex and owned by the caller. Every
+// vertex the search reaches is appended to `reached_vertex_ids` once.
+struct SearchState {
+  std::vector<int>& costs;
+  std::vector<EdgeId>& parent_edge_ids;
+  std::vector<VertexId>& reached_vertex_ids;
+};
+
+// Label-setting search from `source_vertex_id` until
+// `destination_vertex_id` is settled, or over everything reachable for
+// `kNoVertexId`. Vertices leave `queue` by cost plus `lower_bound(vertex)`;
+// the bound must be consistent, which makes this A*, or Dijkstra for
+// `NoLowerBound`. A popped key that no longer matches its vertex is a
+// leftover of a later decrease and is skipped.
+template <typename Queue, typename Weight, typename LowerBound>
+void search(const FrozenGraph& graph,
+            const SearchState& state,
+            Queue& queue,
+            VertexId source_vertex_id,
+            VertexId destination_vertex_id,
+            const Weight& weight,
+            const LowerBound& lower_bound) {
+  auto& costs = state.costs;
+  const auto get_estimate = [&costs, &lower_bound](VertexId vertex_id) {
+    return costs[vertex_id] + lower_bound(vertex_id);
+  };
+  const auto allowed_colors = get_allowed_colors(weight);
+
+  costs[source_vertex_id] = 0;
+  state.reached_vertex_ids.push_back(source_vertex_id);
+  queue.push(source_vertex_id, get_estimate(source_vertex_id));
+  VertexId current_vertex_id = kNoVertexId;
+  int key = 0;
+  while (queue.pop(current_vertex_id, key)) {
+    if (key != get_estimate(current_vertex_id)) {
+      continue;
+    }
+    if (current_vertex_id == destination_vertex_id) {
+      return;
+    }
+    const auto connected_edge_ids =
+        graph.get_connected_edges_ids(current_vertex_id);
+    const auto neighbor_ids = graph.get_neighbor_ids(current_vertex_id);
+    const auto edge_colors = graph.get_connected_edge_colors(current_vertex_id);
+    for (int index = 0; index < connected_edge_ids.size(); ++index) {
+      if constexpr (Weight::kFiltersColors) {
+        if ((edge_colors[index] & allowed_colors) == 0) {
+          continue;
+        }
+      }
+      const auto edge_id = connected_edge_ids[index];
+      const auto edge_cost = weight(graph.get_edge(edge_id));
+      if (edge_cost == kImpassable) {
+        continue;
+      }
+      const auto next_vertex_id = neighbor_ids[index];
+      const auto next_cost = costs[current_vertex_id] + edge_cost;
+      if (next_cost < costs[next_vertex_id]) {
+        if (costs[next_vertex_id] == kMaxCost) {
+          state.reached_vertex_ids.push_back(next_vertex_id);
+        }
+        costs[next_vertex_id] = next_cost;
+        state.parent_edge_ids[next_vertex_id] = edge_id;
+        queue.push(next_vertex_id, get_estimate(next_vertex_id));
+      }
+    }
+  }
+}
+
+// Dynamic programming over the depth levels below the source, following
+// only edges to deeper levels, up to the destination's level or to the
+// last one for `kNoVertexId`. Every edge into a level comes from a
+// shallower one, which is final by then, so the vertices of a level are
+// computed once, independently and in parallel chunks of `chunk_size`.
+template <typename Weight>
+void search_forward(const FrozenGraph& graph,
+                    const SearchState& state,
+                    VertexId source_vertex_id,
+                    VertexId destination_vertex_id,
+                    const Weight& weight,
+                    int chunk_size) {
+  auto& costs = state.costs;
+  auto& parent_edge_ids = state.parent_edge_ids;
+  const auto allowed_colors = get_allowed_colors(weight);
+  const auto last_depth = destination_vertex_id == kNoVertexId
+                              ? graph.get_depth() - 1
+                              : graph.get_vertex_depth(destination_vertex_id);
+
+  costs[source_vertex_id] = 0;
+  state.reached_vertex_ids.push_back(source_vertex_id);
+  for (auto depth = graph.get_vertex_depth(source_vertex_id) + 1;
+       depth <= last_depth; ++depth) {
+    const auto vertex_ids = graph.get_vertex_ids_at_depth(depth);
+    const int chunks_count = (vertex_ids.size() + chunk_size - 1) / chunk_size;
+    ThreadPool::get_thread_pool().parallel_for(
+        0, chunks_count,
+        [depth, chunk_size, allowed_colors, &vertex_ids, &costs,
+         &parent_edge_ids, &weight, &graph](int chunk) {
+          const int chunk_end =
+              std::min<int>((chunk + 1) * chunk_size, vertex_ids.size());
+          for (int index = chunk * chunk_size; index < chunk_end; ++index) {
+            const auto vertex_id = vertex_ids[index];
+            const auto connected_edge_ids =
+                graph.get_connected_edges_ids(vertex_id);
+            const auto neighbor_ids = graph.get_neighbor_ids(vertex_id);
+            const auto edge_colors = graph.get_connected_edge_colors(vertex_id);
+            for (int slot = 0; slot < connected_edge_ids.size(); ++slot) {
+              const auto previous_vertex_id = neighbor_ids[slot];
+              if (graph.get_vertex_depth(previous_vertex_id) >= depth ||
+                  costs[previous_vertex_id] == kMaxCost ||
+                  (edge_colors[slot] & allowed_colors) == 0) {
+                continue;
+              }
+              const auto edge_id = connected_edge_ids[slot];
+              const auto edge_cost = weight(graph.get_edge(edge_id));
+              if (edge_cost == kImpassable) {
+                continue;
+              }
+              const auto cost = costs[previous_vertex_id] + edge_cost;
+              if (cost < costs[vertex_id] ||
+                  (cost == costs[vertex_id] &&
+                   edge_id < parent_edge_ids[vertex_id])) {
+                costs[vertex_id] = cost;
+                parent_edge_ids[vertex_id] = edge_id;
+              }
+            }
+          }
+        });
+    for (const auto vertex_id : vertex_ids) {
+      if (costs[vertex_id] != kMaxCost) {
+        state.reached_vertex_ids.push_back(vertex_id);
+      }
+    }
+  }
+}
+}  // namespace traversal
+}  // namespace uni_course_cpp